@@ -5,11 +5,14 @@
 # WAYLAND_CLIENT_FOUND
 # WAYLAND_CLIENT_INCLUDE_DIRS
 # WAYLAND_CLIENT_LIBRARIES
+# WAYLAND_CURSOR_INCLUDE_DIRS
+# WAYLAND_CURSOR_LIBRARIES
 #
 find_package(PkgConfig REQUIRED)
 pkg_check_modules(WAYLAND_CLIENT REQUIRED wayland-client)
 pkg_check_modules(WAYLAND_EGL REQUIRED wayland-egl)
+pkg_check_modules(WAYLAND_CURSOR REQUIRED wayland-cursor)
 
-mark_as_advanced(WAYLAND_LIBRARIES WAYLAND_CLIENT_LIBRARIES WAYLAND_EGL_LIBRARIES WAYLAND_INCLUDE_DIRS WAYLAND_CLIENT_INCLUDE_DIRS WAYLAND_EGL_INCLUDE_DIRS)
+mark_as_advanced(WAYLAND_LIBRARIES WAYLAND_CLIENT_LIBRARIES WAYLAND_EGL_LIBRARIES WAYLAND_CURSOR_LIBRARIES WAYLAND_INCLUDE_DIRS WAYLAND_CLIENT_INCLUDE_DIRS WAYLAND_EGL_INCLUDE_DIRS WAYLAND_CURSOR_INCLUDE_DIRS)
 
 find_program(WAYLAND_SCANNER NAMES wayland-scanner)
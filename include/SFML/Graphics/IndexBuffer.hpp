@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_INDEXBUFFER_HPP
+#define SFML_INDEXBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/Config.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Index buffer storage, selecting the vertices of
+///        a vertex buffer to draw
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API IndexBuffer : private GlResource
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Usage specifiers
+    ///
+    /// If data is going to be updated once or more every frame,
+    /// set the usage to Stream. If data is going to be set once
+    /// and used for a long time without being modified, set the
+    /// usage to Static. For everything else Dynamic should be a
+    /// good compromise.
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Usage
+    {
+        Stream,  //!< Constantly changing data
+        Dynamic, //!< Occasionally changing data
+        Static   //!< Rarely changing data
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty index buffer.
+    ///
+    ////////////////////////////////////////////////////////////
+    IndexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct an IndexBuffer with a specific usage specifier
+    ///
+    /// Creates an empty index buffer and sets its usage to \p usage.
+    ///
+    /// \param usage Usage specifier
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit IndexBuffer(Usage usage);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    IndexBuffer(const IndexBuffer& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~IndexBuffer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the index buffer
+    ///
+    /// Creates the index buffer and allocates enough graphics
+    /// memory to hold \p indexCount indices. Any previously
+    /// allocated memory is freed in the process.
+    ///
+    /// In order to deallocate previously allocated memory pass 0
+    /// as \p indexCount. Don't forget to recreate with a non-zero
+    /// value when graphics memory should be allocated again.
+    ///
+    /// \param indexCount Number of indices worth of memory to allocate
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool create(std::size_t indexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the index count
+    ///
+    /// \return Number of indices in the index buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getIndexCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the whole buffer from an array of indices
+    ///
+    /// The \a index array is assumed to have the same size as
+    /// the \a created buffer.
+    ///
+    /// No additional check is performed on the size of the index
+    /// array, passing invalid arguments will lead to undefined
+    /// behavior.
+    ///
+    /// This function does nothing if \a indices is null or if the
+    /// buffer was not previously created.
+    ///
+    /// \param indices Array of indices to copy to the buffer
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Uint32* indices);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of the buffer from an array of indices
+    ///
+    /// \p offset is specified as the number of indices to skip
+    /// from the beginning of the buffer.
+    ///
+    /// If \p offset is 0 and \p indexCount is greater than the
+    /// size of the currently created buffer, a new buffer is created
+    /// containing the index data. If \p offset is not 0 and
+    /// \p offset + \p indexCount is greater than the size of the
+    /// currently created buffer, the update fails. Otherwise, only
+    /// the corresponding region is updated.
+    ///
+    /// No additional check is performed on the size of the index
+    /// array, passing invalid arguments will lead to undefined
+    /// behavior.
+    ///
+    /// \param indices    Array of indices to copy to the buffer
+    /// \param indexCount Number of indices to copy
+    /// \param offset     Offset in the buffer to copy to
+    ///
+    /// \return True if the update was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const Uint32* indices, std::size_t indexCount, unsigned int offset);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the contents of another buffer into this buffer
+    ///
+    /// \param indexBuffer Index buffer whose contents to copy into this index buffer
+    ///
+    /// \return True if the copy was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool update(const IndexBuffer& indexBuffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    IndexBuffer& operator =(const IndexBuffer& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this index buffer with those of another
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(IndexBuffer& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the underlying OpenGL handle of the index buffer.
+    ///
+    /// You shouldn't need to use this function, unless you have
+    /// very specific stuff to implement that SFML doesn't support,
+    /// or implement a temporary workaround until a bug is fixed.
+    ///
+    /// \return OpenGL handle of the index buffer or 0 if not yet created
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getNativeHandle() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the usage specifier of this index buffer
+    ///
+    /// This function provides a hint about how this index buffer is
+    /// going to be used in terms of data update frequency.
+    ///
+    /// After changing the usage specifier, the index buffer has
+    /// to be updated with new data for the usage specifier to
+    /// take effect.
+    ///
+    /// The default usage specifier is sf::IndexBuffer::Stream.
+    ///
+    /// \param usage Usage specifier
+    ///
+    ////////////////////////////////////////////////////////////
+    void setUsage(Usage usage);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the usage specifier of this index buffer
+    ///
+    /// \return Usage specifier
+    ///
+    ////////////////////////////////////////////////////////////
+    Usage getUsage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind an index buffer for rendering
+    ///
+    /// This function is not part of the graphics API, it mustn't be
+    /// used when drawing SFML entities. It must be used only if you
+    /// mix sf::IndexBuffer with OpenGL code.
+    ///
+    /// \code
+    /// sf::IndexBuffer ib;
+    /// ...
+    /// sf::IndexBuffer::bind(&ib);
+    /// // draw OpenGL stuff that use ib...
+    /// sf::IndexBuffer::bind(NULL);
+    /// // draw OpenGL stuff that use no index buffer...
+    /// \endcode
+    ///
+    /// \param indexBuffer Pointer to the index buffer to bind, can be null to use no index buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    static void bind(const IndexBuffer* indexBuffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports index buffers
+    ///
+    /// This function should always be called before using
+    /// the index buffer features. If it returns false, then
+    /// any attempt to use sf::IndexBuffer will fail.
+    ///
+    /// \return True if index buffers are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int m_buffer; //!< Internal buffer identifier
+    std::size_t  m_size;   //!< Size in indices of the currently allocated buffer
+    Usage        m_usage;  //!< How this index buffer is to be used
+};
+
+} // namespace sf
+
+
+#endif // SFML_INDEXBUFFER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::IndexBuffer
+/// \ingroup graphics
+///
+/// sf::IndexBuffer is a simple wrapper around a dynamic
+/// buffer of 32-bit vertex indices, stored in graphics memory.
+///
+/// It is drawn together with a sf::VertexBuffer: instead of
+/// reading the vertices in order, each primitive of the
+/// vertex buffer's primitive type is built from the vertices
+/// selected by the indices. Vertices shared by several
+/// primitives, like the corners of adjacent tiles, can then
+/// be stored once, and the graphics card can reuse their
+/// transformed positions instead of processing them again.
+///
+/// Indexed geometry that changes every frame can also be
+/// drawn directly from system memory, with the
+/// sf::RenderTarget::draw overload taking arrays of vertices
+/// and indices.
+///
+/// Example:
+/// \code
+/// // Two triangles sharing an edge make a quad of 4 vertices
+/// sf::Vertex vertices[4];
+/// ...
+/// sf::Uint32 indices[] = {0, 1, 2, 2, 1, 3};
+///
+/// sf::VertexBuffer vertexBuffer(sf::Triangles, sf::VertexBuffer::Static);
+/// vertexBuffer.create(4);
+/// vertexBuffer.update(vertices);
+///
+/// sf::IndexBuffer indexBuffer(sf::IndexBuffer::Static);
+/// indexBuffer.create(6);
+/// indexBuffer.update(indices);
+/// ...
+/// window.draw(vertexBuffer, indexBuffer);
+/// \endcode
+///
+/// \see sf::VertexBuffer, sf::RenderTarget
+///
+////////////////////////////////////////////////////////////
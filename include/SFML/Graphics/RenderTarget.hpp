@@ -38,13 +38,22 @@
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf
 {
 class Drawable;
+class IndexBuffer;
+class SpriteBatch;
 class VertexBuffer;
 
+namespace priv
+{
+    class CoreRenderer;
+    class VertexStream;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Base class for all render targets (window, texture, ...)
 ///
@@ -124,7 +133,7 @@ public:
     ///
     /// \param view The view for which we want to compute the viewport
     ///
-    /// \return Viewport rectangle, expressed in pixels
+    /// \return Viewport rectangle, expressed in pixels (in the units of getSize())
     ///
     ////////////////////////////////////////////////////////////
     IntRect getViewport(const View& view) const;
@@ -248,6 +257,29 @@ public:
     void draw(const Vertex* vertices, std::size_t vertexCount,
               PrimitiveType type, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives defined by arrays of vertices and indices
+    ///
+    /// The primitives are built from the vertices selected by
+    /// the indices, in order, so that vertices shared by several
+    /// primitives are only stored once.
+    ///
+    /// The sf::Quads primitive type is not supported with core
+    /// profile contexts. Nothing is drawn if an index is out of
+    /// range of the vertex array.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param indices     Pointer to the indices of the vertices to draw
+    /// \param indexCount  Number of indices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Vertex* vertices, std::size_t vertexCount,
+              const Uint32* indices, std::size_t indexCount,
+              PrimitiveType type, const RenderStates& states = RenderStates::Default);
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw primitives defined by a vertex buffer
     ///
@@ -268,6 +300,105 @@ public:
     ////////////////////////////////////////////////////////////
     void draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives defined by a vertex buffer and an index buffer
+    ///
+    /// The primitive type of the vertex buffer is used. The
+    /// sf::Quads primitive type is not supported with core
+    /// profile contexts.
+    ///
+    /// The indices live in graphics memory and can't be checked:
+    /// they must all be smaller than the vertex count of the
+    /// vertex buffer, otherwise the result is undefined.
+    ///
+    /// \param vertexBuffer Vertex buffer
+    /// \param indexBuffer  Index buffer selecting the vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, const IndexBuffer& indexBuffer, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives defined by a vertex buffer and an index buffer
+    ///
+    /// The used indices must all be smaller than the vertex count
+    /// of the vertex buffer, otherwise the result is undefined.
+    ///
+    /// \param vertexBuffer Vertex buffer
+    /// \param indexBuffer  Index buffer selecting the vertices to draw
+    /// \param firstIndex   Index of the first index to use
+    /// \param indexCount   Number of indices to use
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const VertexBuffer& vertexBuffer, const IndexBuffer& indexBuffer, std::size_t firstIndex, std::size_t indexCount, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw all the sprites of a sprite batch
+    ///
+    /// The texture of the batch replaces the one of the render
+    /// states. Giving a shader in the render states disables
+    /// instanced rendering, the vertices of the sprites are
+    /// then built on the CPU.
+    ///
+    /// \param spriteBatch Sprite batch to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const SpriteBatch& spriteBatch, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable automatic batching of draw calls
+    ///
+    /// When batching is enabled, consecutive draws of vertex
+    /// arrays (sprites, texts, shapes, ...) that use the same
+    /// texture, shader and blend mode are not sent to the
+    /// graphics card immediately: their vertices are transformed
+    /// on the CPU and accumulated, and the whole batch is then
+    /// rendered with a single draw call. The batch is flushed
+    /// automatically when the render states change, when the view
+    /// changes, when the target is cleared, deactivated or
+    /// displayed, or explicitly with flush().
+    ///
+    /// Since pending draws are rendered later, textures and
+    /// shader parameters that they use must not be modified
+    /// before the batch has been flushed. Shaders also receive
+    /// vertices that are already transformed, with an identity
+    /// model-view matrix.
+    ///
+    /// Batching is disabled by default.
+    ///
+    /// \param enabled True to enable batching, false to disable it
+    ///
+    /// \see isBatchingEnabled, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBatchingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether automatic batching of draw calls is enabled
+    ///
+    /// \return True if batching is enabled, false otherwise
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBatchingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Render the draws that are pending in the current batch
+    ///
+    /// This function only has an effect when batching is enabled.
+    /// It must be called before modifying a texture or a shader
+    /// that is used by pending draws, before reading back the
+    /// contents of the target and before issuing direct OpenGL
+    /// commands that depend on what has been drawn so far.
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -276,6 +407,20 @@ public:
     ////////////////////////////////////////////////////////////
     virtual Vector2u getSize() const = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of the framebuffer of the target
+    ///
+    /// Views, viewports and mapPixelToCoords work in the units
+    /// of getSize(). This is the size of the pixels actually
+    /// rendered, which is larger for windows rendered at a high
+    /// DPI, and smaller for windows rendered at a reduced scale.
+    /// The default implementation returns getSize().
+    ///
+    /// \return Size of the framebuffer, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Vector2u getFramebufferSize() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the render target for rendering
     ///
@@ -327,6 +472,10 @@ public:
     /// saved and restored). Take a look at the resetGLStates
     /// function if you do so.
     ///
+    /// Core profile contexts can't save the OpenGL states: there,
+    /// pushGLStates only resets the states needed by SFML, and
+    /// popGLStates unbinds the objects that SFML uses for drawing.
+    ///
     /// \see popGLStates
     ///
     ////////////////////////////////////////////////////////////
@@ -442,6 +591,19 @@ private:
     ////////////////////////////////////////////////////////////
     void drawPrimitives(PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the primitives selected by indices
+    ///
+    /// This is only used with the fixed-function pipeline, core
+    /// profile contexts draw through priv::CoreRenderer.
+    ///
+    /// \param type       Type of primitives to draw
+    /// \param indices    Pointer to the indices, or offset in the bound index buffer
+    /// \param indexCount Number of indices to use when drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawIndexedPrimitives(PrimitiveType type, const void* indices, std::size_t indexCount);
+
     ////////////////////////////////////////////////////////////
     /// \brief Clean up environment after drawing
     ///
@@ -450,6 +612,30 @@ private:
     ////////////////////////////////////////////////////////////
     void cleanupDraw(const RenderStates& states);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives defined by an array of vertices, bypassing the batch
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawVertices(const Vertex* vertices, std::size_t vertexCount,
+                      PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append primitives to the current batch
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void batchVertices(const Vertex* vertices, std::size_t vertexCount,
+                       PrimitiveType type, const RenderStates& states);
+
     ////////////////////////////////////////////////////////////
     /// \brief Render states cache
     ///
@@ -465,16 +651,25 @@ private:
         Uint64    lastTextureId;  //!< Cached texture
         bool      texCoordsArrayEnabled; //!< Is GL_TEXTURE_COORD_ARRAY client state enabled?
         bool      useVertexCache; //!< Did we previously use the vertex cache?
+        bool      coreProfile;    //!< Is the context a core profile context, without fixed-function pipeline?
+        Uint64    streamId;       //!< Stream buffer targeted by the vertex pointers (see priv::VertexStream), 0 if they target client memory
         Vertex    vertexCache[VertexCacheSize]; //!< Pre-transformed vertices cache
     };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        m_defaultView; //!< Default view
-    View        m_view;        //!< Current view
-    StatesCache m_cache;       //!< Render states cache
-    Uint64      m_id;          //!< Unique number that identifies the RenderTarget
+    View                m_defaultView;     //!< Default view
+    View                m_view;            //!< Current view
+    StatesCache         m_cache;           //!< Render states cache
+    Uint64              m_id;              //!< Unique number that identifies the RenderTarget
+    bool                m_batchingEnabled; //!< Are draw calls batched?
+    std::vector<Vertex> m_batchVertices;   //!< Pre-transformed vertices of the pending draws
+    PrimitiveType       m_batchType;       //!< Type of primitives in the current batch
+    RenderStates        m_batchStates;     //!< Render states of the current batch (always with an identity transform)
+    Uint64              m_batchTextureId;  //!< Cache identifier of the batch texture, to detect updates
+    priv::CoreRenderer* m_coreRenderer;    //!< Pipeline used in core profile contexts, created on demand
+    priv::VertexStream* m_vertexStream;    //!< Ring buffer into which vertex arrays are streamed, created on demand
 };
 
 } // namespace sf
@@ -505,6 +700,18 @@ private:
 /// OpenGL states are not messed up by calling the
 /// pushGLStates/popGLStates functions.
 ///
+/// Render targets whose context is a core profile context (see
+/// sf::ContextSettings::Core) don't have the fixed-function
+/// pipeline: they stream the vertices into a buffer object and
+/// render them with a built-in shader instead. Drawing works the
+/// same way, but custom shaders must then use the attributes and
+/// uniforms described in sf::Shader.
+///
+/// Render targets with many small objects to draw can enable
+/// automatic batching with setBatchingEnabled: consecutive
+/// draws sharing the same texture, shader and blend mode are
+/// then merged into a single draw call.
+///
 /// \see sf::RenderWindow, sf::RenderTexture, sf::View
 ///
 ////////////////////////////////////////////////////////////
@@ -32,6 +32,7 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Window/ContextSettings.hpp>
+#include <SFML/Window/DmaBuf.hpp>
 
 
 namespace sf
@@ -233,6 +234,35 @@ public:
     ////////////////////////////////////////////////////////////
     const Texture& getTexture() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Share the target texture with other processes or APIs
+    ///
+    /// This function exports the storage of the target texture as
+    /// a Linux DMA buffer, so that another process (a video encoder,
+    /// a compositor...) or API (Vulkan, VA-API...) can read it with
+    /// no copy at all. Call it after display(): the rendering
+    /// commands are flushed, and the buffer implicitly waits for
+    /// them to complete. Since the buffer shares the storage of
+    /// the texture, it only needs to be exported once; later
+    /// frames show up in it as well.
+    ///
+    /// The rows of the image are stored bottom to top, like all
+    /// OpenGL render targets. The file descriptors of the buffer
+    /// belong to the caller, who must close them when done.
+    ///
+    /// DMA buffers are only supported on some platforms (currently
+    /// Linux with Wayland and EGL_MESA_image_dma_buf_export);
+    /// elsewhere this function fails.
+    ///
+    /// \param buffer Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false otherwise
+    ///
+    /// \see display
+    ///
+    ////////////////////////////////////////////////////////////
+    bool exportDmaBuf(DmaBuf& buffer);
+
 private:
 
     ////////////////////////////////////////////////////////////
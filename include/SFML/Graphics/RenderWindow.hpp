@@ -105,13 +105,32 @@ public:
     /// \brief Get the size of the rendering region of the window
     ///
     /// The size doesn't include the titlebar and borders
-    /// of the window.
+    /// of the window. It is expressed in the units of the
+    /// desktop, like mouse events and sf::Mouse::getPosition,
+    /// so the default view and mapPixelToCoords work with mouse
+    /// coordinates even if high DPI rendering is enabled or a
+    /// render scale is set.
     ///
     /// \return Size in pixels
     ///
+    /// \see getFramebufferSize
+    ///
     ////////////////////////////////////////////////////////////
     virtual Vector2u getSize() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the framebuffer of the window
+    ///
+    /// It differs from getSize() if high DPI rendering is enabled
+    /// or a render scale is set.
+    ///
+    /// \return Size of the framebuffer, in pixels
+    ///
+    /// \see Window::setHighDpiEnabled, Window::setRenderScale
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Vector2u getFramebufferSize() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the window as the current target
     ///        for OpenGL rendering
@@ -178,6 +197,15 @@ protected:
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// This function is called so that the draws which are
+    /// still pending in the current batch end up on screen.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private:
 
     ////////////////////////////////////////////////////////////
@@ -870,6 +870,19 @@ private:
 /// sf::Shader::bind(NULL);
 /// \endcode
 ///
+/// When rendering with a core profile context (see
+/// sf::ContextSettings::Core), the built-in variables of the
+/// fixed-function pipeline such as gl_Vertex or gl_ModelViewMatrix
+/// don't exist. Vertex shaders must then declare the attributes
+/// and uniforms that sf::RenderTarget provides instead:
+/// \code
+/// in vec2 sf_position;            // vertex position
+/// in vec4 sf_color;               // vertex color
+/// in vec2 sf_texCoords;           // vertex texture coordinates
+/// uniform mat4 sf_transform;      // projection * model-view matrix
+/// uniform mat4 sf_textureMatrix;  // texture matrix, converting pixels to normalized coordinates
+/// \endcode
+///
 /// \see sf::Glsl
 ///
 ////////////////////////////////////////////////////////////
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SPRITEBATCH_HPP
+#define SFML_SPRITEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Shader;
+class Sprite;
+class Texture;
+class Transform;
+
+////////////////////////////////////////////////////////////
+/// \brief Set of sprites sharing the same texture, drawn
+///        with a single draw call
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API SpriteBatch : public Drawable, private GlResource
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch with no source texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the batch from a source texture
+    ///
+    /// \param texture Source texture shared by all the sprites
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SpriteBatch(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch(const SpriteBatch& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SpriteBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch& operator =(const SpriteBatch& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this batch with those of another
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(SpriteBatch& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the source texture of the batch
+    ///
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the batch uses it. Indeed, the batch
+    /// doesn't store its own copy of the texture, but rather keeps
+    /// a pointer to the one that you passed to this function.
+    /// If the source texture is destroyed and the batch tries to
+    /// use it, the behavior is undefined.
+    ///
+    /// \param texture New texture
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the source texture of the batch
+    ///
+    /// If the batch has no source texture, a NULL pointer is returned.
+    ///
+    /// \return Pointer to the batch's texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a sprite to the batch
+    ///
+    /// The transform, texture rectangle and color of the sprite
+    /// are copied into the batch; its texture is ignored, the
+    /// one of the batch is used instead.
+    ///
+    /// \param sprite Sprite to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Sprite& sprite);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a sprite to the batch
+    ///
+    /// \param transform   Transform of the sprite
+    /// \param textureRect Sub-rectangle of the texture to display
+    /// \param color       Global color of the sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Transform& transform, const IntRect& textureRect, const Color& color = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the sprites from the batch
+    ///
+    /// The memory allocated for the sprites is kept, so that
+    /// the batch can be refilled on each frame without
+    /// reallocating it.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of sprites in the batch
+    ///
+    /// \return Number of sprites
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSpriteCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports instanced rendering
+    ///
+    /// Instanced rendering requires shaders, vertex buffers,
+    /// and OpenGL 3.3 or the ARB_instanced_arrays and
+    /// ARB_draw_instanced extensions. When it's unavailable,
+    /// batches are still drawn with a single draw call, but
+    /// the vertices of the sprites are built on the CPU.
+    ///
+    /// \return True if instanced rendering is supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isInstancingAvailable();
+
+private:
+
+    friend class RenderTarget;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Per-instance data of a sprite
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Instance
+    {
+        float transform[6];   //!< First two rows of the 3x3 affine transform
+        float textureRect[4]; //!< Left, top, width and height of the texture rectangle
+        Color color;          //!< Global color of the sprite
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the batch to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader rendering the instances
+    ///
+    /// The shader is shared by all the batches, and compiled on
+    /// first use for each kind of context. The instance buffer
+    /// is updated as well if the sprites changed since the last
+    /// draw.
+    ///
+    /// \param coreProfile Is the active context a core profile context?
+    ///
+    /// \return Instancing shader, or NULL if instancing failed
+    ///
+    ////////////////////////////////////////////////////////////
+    const Shader* prepareInstancing(bool coreProfile) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the instances with the unit quad bound
+    ///
+    /// The instancing shader, the texture and the attributes
+    /// of the unit quad must already be set up.
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawInstances() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the vertices of the sprites, built on the CPU
+    ///
+    /// This is the fallback used when instancing is unavailable.
+    ///
+    /// \return Independent triangles of all the sprites
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Vertex>& getVertices() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const Texture*              m_texture;             //!< Texture shared by the sprites
+    std::vector<Instance>       m_instances;           //!< Per-instance data of the sprites
+    mutable std::vector<Vertex> m_vertices;            //!< Vertices of the sprites, for the fallback
+    mutable bool                m_verticesNeedUpdate;  //!< Do the vertices need to be rebuilt?
+    mutable bool                m_instancesNeedUpload; //!< Does the instance buffer need to be updated?
+    mutable unsigned int        m_instanceBuffer;      //!< Buffer holding the per-instance data
+    mutable VertexBuffer        m_quad;                //!< Unit quad instanced for each sprite
+    mutable int                 m_attributes[4];       //!< Locations of the per-instance attributes in the shader of the last draw
+};
+
+} // namespace sf
+
+
+#endif // SFML_SPRITEBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SpriteBatch
+/// \ingroup graphics
+///
+/// sf::SpriteBatch stores many sprites that use the same
+/// texture, and draws all of them with a single draw call.
+/// It is meant for large numbers of small similar objects,
+/// such as particles, tiles or bullets, which would be too
+/// expensive to draw one by one with sf::Sprite.
+///
+/// Each sprite of the batch is defined by a transform, a
+/// rectangle of the texture to display and a color, exactly
+/// like a sf::Sprite. Only this per-sprite data is uploaded
+/// to the graphics card: with instanced rendering, a single
+/// quad is drawn once per sprite by a built-in shader. When
+/// instanced rendering is not supported (see
+/// isInstancingAvailable), or when a custom shader is given
+/// in the render states, the vertices of the sprites are
+/// built on the CPU instead.
+///
+/// The built-in shader uses the texture of the batch; the
+/// texture of the render states is ignored.
+///
+/// Usage example:
+/// \code
+/// // Declare and load a texture
+/// sf::Texture texture;
+/// texture.loadFromFile("particles.png");
+///
+/// // Create the batch
+/// sf::SpriteBatch batch(texture);
+///
+/// // On each frame, fill it and draw it
+/// batch.clear();
+/// for (std::size_t i = 0; i < particles.size(); ++i)
+/// {
+///     sf::Transform transform;
+///     transform.translate(particles[i].position).rotate(particles[i].angle);
+///     batch.add(transform, sf::IntRect(0, 0, 8, 8), particles[i].color);
+/// }
+/// window.draw(batch);
+/// \endcode
+///
+/// \see sf::Sprite, sf::Texture, sf::VertexBuffer
+///
+////////////////////////////////////////////////////////////
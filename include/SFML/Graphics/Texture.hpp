@@ -31,6 +31,7 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Window/GlResource.hpp>
+#include <SFML/Window/DmaBuf.hpp>
 
 
 namespace sf
@@ -214,6 +215,102 @@ public:
     ////////////////////////////////////////////////////////////
     bool loadFromImage(const Image& image, const IntRect& area = IntRect());
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the pixels of the texture
+    ///
+    /// Unlike the other load functions, nothing is copied: the
+    /// texture samples the buffer directly, so that video frames
+    /// decoded by the hardware or captured by a camera can be
+    /// drawn with no copy at all. Whatever is later written to
+    /// the buffer shows up in the texture, so the producer and the
+    /// GPU must take turns: see waitFence() and createFence().
+    ///
+    /// The file descriptors of the buffer still belong to the
+    /// caller, who may close them right away. Imported textures
+    /// have no mipmap, and their format may not be renderable.
+    ///
+    /// DMA buffers are only supported on some platforms (currently
+    /// Linux with Wayland and EGL_EXT_image_dma_buf_import);
+    /// elsewhere this function fails.
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param buffer DMA buffer to use
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromEglImage, waitFence, createFence
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromDmaBuf(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the pixels of the texture
+    ///
+    /// This is the same as loadFromDmaBuf, for images that the
+    /// application (or another library) already imported into EGL.
+    /// The texture keeps the storage of the image alive, so the
+    /// image may be destroyed right away.
+    ///
+    /// EGL images are only supported on some platforms (currently
+    /// Linux with Wayland and GL_OES_EGL_image); elsewhere this
+    /// function fails.
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param image  EGLImage to use
+    /// \param width  Width of the image, in pixels
+    /// \param height Height of the image, in pixels
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromDmaBuf
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromEglImage(void* image, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the GPU wait for a fence before sampling the texture
+    ///
+    /// When the producer of an imported buffer hands over a new
+    /// frame along with a fence (a Linux sync file) signaled when
+    /// it is done writing it, this function makes the following
+    /// draw commands of the active context wait for it, without
+    /// blocking the CPU if the driver supports it.
+    ///
+    /// A context must be active: the wait only applies to its
+    /// commands, and this function fails if none is. The fence
+    /// belongs to the texture after this call, even if it fails.
+    ///
+    /// \param fence File descriptor of the fence
+    ///
+    /// \return True if the wait was queued (or done), false if no context is active or fences aren't supported
+    ///
+    /// \see createFence, loadFromDmaBuf
+    ///
+    ////////////////////////////////////////////////////////////
+    bool waitFence(int fence);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a fence signaled when the GPU is done sampling the texture
+    ///
+    /// Call this function with the context that draws the texture
+    /// active (e.g. right after the draw calls of a frame). The
+    /// returned fence (a Linux sync file) is signaled once the GPU
+    /// completes all the commands issued so far, at which point the
+    /// producer of an imported buffer may write to it again. The
+    /// fence belongs to the caller, who must close it.
+    ///
+    /// The fence only covers the commands of the active context;
+    /// this function fails if no context is active.
+    ///
+    /// \return File descriptor of the fence, -1 if no context is active or fences aren't supported
+    ///
+    /// \see waitFence, loadFromDmaBuf
+    ///
+    ////////////////////////////////////////////////////////////
+    int createFence() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the texture
     ///
@@ -563,7 +660,8 @@ public:
     /// in pixels (range [0 .. size]). This mode is used internally by
     /// the graphics classes of SFML, it makes the definition of texture
     /// coordinates more intuitive for the high-level API, users don't need
-    /// to compute normalized values.
+    /// to compute normalized values. Core profile contexts have no
+    /// texture matrix, so there the coordinates are always normalized.
     ///
     /// \param texture Pointer to the texture to bind, can be null to use no texture
     /// \param coordinateType Type of texture coordinates to use
@@ -604,6 +702,19 @@ private:
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Use external memory as the pixels of the texture
+    ///
+    /// \param buffer DMA buffer to use, or NULL
+    /// \param image  EGL image to use if \a buffer is NULL
+    /// \param width  Width of the external image, in pixels
+    /// \param height Height of the external image, in pixels
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromExternal(const DmaBuf* buffer, void* image, unsigned int width, unsigned int height);
+
     ////////////////////////////////////////////////////////////
     /// \brief Invalidate the mipmap if one exists
     ///
@@ -613,6 +724,15 @@ private:
     ////////////////////////////////////////////////////////////
     void invalidateMipmap();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the matrix that must be applied to texture coordinates
+    ///
+    /// \param coordinateType Type of texture coordinates to use
+    /// \param matrix         Filled with the 4x4 matrix, in column-major order
+    ///
+    ////////////////////////////////////////////////////////////
+    void getTextureMatrix(CoordinateType coordinateType, float matrix[16]) const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
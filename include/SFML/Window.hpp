@@ -34,9 +34,12 @@
 #include <SFML/Window/Context.hpp>
 #include <SFML/Window/ContextSettings.hpp>
 #include <SFML/Window/Cursor.hpp>
+#include <SFML/Window/DmaBuf.hpp>
 #include <SFML/Window/Event.hpp>
+#include <SFML/Window/FrameTiming.hpp>
 #include <SFML/Window/Joystick.hpp>
 #include <SFML/Window/Keyboard.hpp>
+#include <SFML/Window/Monitor.hpp>
 #include <SFML/Window/Mouse.hpp>
 #include <SFML/Window/Sensor.hpp>
 #include <SFML/Window/Touch.hpp>
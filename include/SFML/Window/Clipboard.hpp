@@ -42,6 +42,15 @@ class SFML_WINDOW_API Clipboard
 {
 public:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Type of the function receiving the clipboard contents
+    ///
+    /// The first argument is the content of the clipboard, the
+    /// second one is the user data given to requestString.
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef void (*StringCallback)(const String& text, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the content of the clipboard as string data
     ///
@@ -54,6 +63,28 @@ public:
     ////////////////////////////////////////////////////////////
     static String getString();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Request the content of the clipboard as string data
+    ///
+    /// Unlike getString, this function never waits for the
+    /// application owning the clipboard: the callback is
+    /// called with the content of the clipboard once it has
+    /// been fully received, which makes it the preferred way
+    /// to paste large amounts of text. If the clipboard does
+    /// not contain string the callback receives an empty
+    /// sf::String object.
+    ///
+    /// The callback may be called before this function returns,
+    /// when the content is already known. Otherwise it is called
+    /// from the event processing of a window (sf::Window::pollEvent
+    /// or sf::Window::waitEvent), in the thread handling events.
+    ///
+    /// \param callback Function to call with the clipboard contents
+    /// \param userData User data passed to the callback
+    ///
+    ////////////////////////////////////////////////////////////
+    static void requestString(StringCallback callback, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the content of the clipboard as string data
     ///
@@ -90,6 +121,11 @@ public:
 /// only guaranteed to work if there is currently an open
 /// window for which events are being handled.
 ///
+/// Large contents may take a while to be transferred from
+/// another application. sf::Clipboard::requestString receives
+/// them without blocking, through a callback called during
+/// window event processing.
+///
 /// Usage example:
 /// \code
 /// // get the clipboard content as a string
@@ -31,6 +31,7 @@
 #include <SFML/Window/Export.hpp>
 #include <SFML/Window/GlResource.hpp>
 #include <SFML/Window/ContextSettings.hpp>
+#include <SFML/Window/DmaBuf.hpp>
 #include <SFML/System/NonCopyable.hpp>
 
 
@@ -109,6 +110,83 @@ public:
     ////////////////////////////////////////////////////////////
     static GlFunctionPointer getFunction(const char* name);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Export an OpenGL texture as a DMA buffer
+    ///
+    /// The texture must belong to the active context (or to a
+    /// context it shares its resources with), and only its first
+    /// level is exported. The DMA buffer shares its storage with
+    /// the texture: it reflects everything later rendered into it.
+    /// Its file descriptors belong to the caller, who must close
+    /// them. The width and height of the buffer are left
+    /// untouched, since they are known by the owner of the texture.
+    ///
+    /// This function is for internal use, use
+    /// sf::RenderTexture::exportDmaBuf instead.
+    ///
+    /// \param texture OpenGL name of the texture to export
+    /// \param buffer  Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false if DMA buffers aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool exportTexture(unsigned int texture, DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the storage of a texture
+    ///
+    /// The buffer becomes the storage of the texture currently
+    /// bound to GL_TEXTURE_2D in the active context; nothing is
+    /// copied. The file descriptors of the buffer still belong
+    /// to the caller.
+    ///
+    /// This function is for internal use, use
+    /// sf::Texture::loadFromDmaBuf instead.
+    ///
+    /// \param buffer Description of the DMA buffer to import
+    ///
+    /// \return True on success, false if DMA buffers aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool importTexture(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the storage of a texture
+    ///
+    /// The image becomes the storage of the texture currently
+    /// bound to GL_TEXTURE_2D in the active context; nothing is
+    /// copied.
+    ///
+    /// This function is for internal use, use
+    /// sf::Texture::loadFromEglImage instead.
+    ///
+    /// \param image EGLImage to import
+    ///
+    /// \return True on success, false if EGL images aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool importTexture(void* image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a fence signaled when the GPU completes the commands issued so far
+    ///
+    /// The commands of the active context are flushed.
+    ///
+    /// \return File descriptor of the fence (a Linux sync file), -1 if no context is active or fences aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static int createFence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the GPU wait for a fence before executing the next commands
+    ///
+    /// \param fence File descriptor of the fence (a Linux sync file), owned by the function
+    ///
+    /// \return True on success, false if no context is active or fences aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool waitFence(int fence);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the currently active context
     ///
@@ -132,6 +210,17 @@ public:
     ////////////////////////////////////////////////////////////
     static Uint64 getActiveContextId();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the settings of the currently active context
+    ///
+    /// Unlike getActiveContext, this function also works for
+    /// contexts created by RenderTargets or for internal use.
+    ///
+    /// \return Settings of the active context, or default settings if no context is currently active
+    ///
+    ////////////////////////////////////////////////////////////
+    static ContextSettings getActiveContextSettings();
+
     ////////////////////////////////////////////////////////////
     /// \brief Construct a in-memory context
     ///
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_DMABUF_HPP
+#define SFML_DMABUF_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Structure describing a Linux DMA buffer holding an image
+///
+////////////////////////////////////////////////////////////
+struct DmaBuf
+{
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty buffer, with no planes and an unknown
+    /// modifier (DRM_FORMAT_MOD_INVALID).
+    ///
+    ////////////////////////////////////////////////////////////
+    DmaBuf() :
+    width     (0),
+    height    (0),
+    format    (0),
+    modifier  ((static_cast<Uint64>(0x00ffffff) << 32) | 0xffffffff),
+    planeCount(0)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            fds[i]     = -1;
+            offsets[i] = 0;
+            strides[i] = 0;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int width;      //!< Width of the image, in pixels
+    unsigned int height;     //!< Height of the image, in pixels
+    Uint32       format;     //!< DRM fourcc code of the pixel format
+    Uint64       modifier;   //!< DRM format modifier describing the tiling or compression of the planes, DRM_FORMAT_MOD_INVALID to let the driver guess
+    unsigned int planeCount; //!< Number of planes actually used
+    int          fds[4];     //!< File descriptor of each plane, -1 if unused
+    Uint32       offsets[4]; //!< Offset of each plane in its file, in bytes
+    Uint32       strides[4]; //!< Size of a row of each plane, in bytes
+};
+
+} // namespace sf
+
+
+#endif // SFML_DMABUF_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \struct sf::DmaBuf
+/// \ingroup window
+///
+/// sf::DmaBuf describes an image stored in GPU memory that can
+/// be shared between processes and APIs (OpenGL, Vulkan, video
+/// encoders and decoders, compositors...) without any copy,
+/// through the DMA buffer sharing framework of Linux.
+///
+/// The image is made of up to 4 planes (most RGB formats only
+/// use one), each one referenced by a file descriptor. The
+/// \a format and \a modifier are those defined in the
+/// drm_fourcc.h header of the Linux kernel. The modifier
+/// defaults to DRM_FORMAT_MOD_INVALID, which means that the
+/// layout is implicit (known to the driver): set it to
+/// DRM_FORMAT_MOD_LINEAR explicitly for untiled images.
+///
+/// DMA buffers are only supported on some platforms (currently
+/// Linux with Wayland and EGL). Elsewhere, the functions that
+/// produce them always fail.
+///
+/// Usage example:
+/// \code
+/// sf::RenderTexture texture;
+/// texture.create(1280, 720);
+/// ...
+/// texture.display();
+///
+/// sf::DmaBuf buffer;
+/// if (texture.exportDmaBuf(buffer))
+/// {
+///     sendToEncoder(buffer);
+///     for (unsigned int i = 0; i < buffer.planeCount; ++i)
+///         close(buffer.fds[i]);
+/// }
+/// \endcode
+///
+/// \see sf::RenderTexture::exportDmaBuf
+///
+////////////////////////////////////////////////////////////
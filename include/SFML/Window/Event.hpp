@@ -87,6 +87,16 @@ public:
         int y; //!< Y position of the mouse pointer, relative to the top of the owner window
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Raw mouse move event parameters (MouseMovedRaw)
+    ///
+    ////////////////////////////////////////////////////////////
+    struct MouseMoveRawEvent
+    {
+        float dx; //!< Horizontal motion of the mouse, before acceleration
+        float dy; //!< Vertical motion of the mouse, before acceleration
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Mouse buttons events parameters
     ///        (MouseButtonPressed, MouseButtonReleased)
@@ -209,6 +219,7 @@ public:
         TouchMoved,             //!< A touch moved (data in event.touch)
         TouchEnded,             //!< A touch event ended (data in event.touch)
         SensorChanged,          //!< A sensor value changed (data in event.sensor)
+        MouseMovedRaw,          //!< The mouse moved, regardless of the cursor (data in event.mouseMoveRaw)
 
         Count                   //!< Keep last -- the total number of event types
     };
@@ -232,6 +243,7 @@ public:
         JoystickConnectEvent  joystickConnect;   //!< Joystick (dis)connect event parameters (Event::JoystickConnected, Event::JoystickDisconnected)
         TouchEvent            touch;             //!< Touch events parameters (Event::TouchBegan, Event::TouchMoved, Event::TouchEnded)
         SensorEvent           sensor;            //!< Sensor event parameters (Event::SensorChanged)
+        MouseMoveRawEvent     mouseMoveRaw;      //!< Raw mouse move event parameters (Event::MouseMovedRaw)
     };
 };
 
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_FRAMETIMING_HPP
+#define SFML_FRAMETIMING_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/System/Time.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Structure describing how a frame was presented
+///
+////////////////////////////////////////////////////////////
+struct FrameTiming
+{
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameTiming() :
+    frame          (0),
+    presented      (false),
+    timestamp      (Time::Zero),
+    latency        (Time::Zero),
+    refreshInterval(Time::Zero),
+    vsync          (false)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Uint64 frame;           //!< Index of the frame, counting the calls to Window::display()
+    bool   presented;       //!< True if the frame was shown, false if it was discarded
+    Time   timestamp;       //!< Time at which the frame was shown, on the system's monotonic clock
+    Time   latency;         //!< Time between the call to Window::display() and the presentation
+    Time   refreshInterval; //!< Refresh interval of the output, Time::Zero if variable or unknown
+    bool   vsync;           //!< True if the presentation was synchronized to the vertical retrace
+};
+
+} // namespace sf
+
+
+#endif // SFML_FRAMETIMING_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::FrameTiming
+/// \ingroup window
+///
+/// sf::FrameTiming reports what happened to a frame after it
+/// was submitted with sf::Window::display(): whether the
+/// compositor actually showed it or discarded it (because
+/// a newer frame replaced it, or the window was hidden), and
+/// when it turned into light.
+///
+/// This information is only available on platforms whose
+/// compositor reports presentation feedback (currently Wayland,
+/// through the wp_presentation protocol). Elsewhere, no
+/// timings are ever returned.
+///
+/// Usage example:
+/// \code
+/// window.display();
+///
+/// sf::FrameTiming timing;
+/// while (window.pollFrameTiming(timing))
+/// {
+///     if (timing.presented)
+///         std::cout << "frame " << timing.frame << " shown after "
+///                   << timing.latency.asMicroseconds() << " us" << std::endl;
+/// }
+/// \endcode
+///
+/// \see sf::Window::pollFrameTiming
+///
+////////////////////////////////////////////////////////////
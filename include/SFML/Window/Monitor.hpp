@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_MONITOR_HPP
+#define SFML_MONITOR_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/Export.hpp>
+#include <SFML/Window/VideoMode.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// \brief Monitor describes a display connected to the system
+///
+////////////////////////////////////////////////////////////
+class SFML_WINDOW_API Monitor
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// This constructors initializes all members to 0.
+    ///
+    ////////////////////////////////////////////////////////////
+    Monitor();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the list of the monitors connected to the system
+    ///
+    /// Unlike VideoMode::getFullscreenModes, the list is not cached:
+    /// each call reflects the monitors known at the time of the call.
+    /// Monitors plugged or unplugged while windows are open are
+    /// noticed when the events of these windows are processed.
+    /// On platforms that can't enumerate monitors, a single monitor
+    /// built from the desktop mode and fullscreen modes is returned.
+    ///
+    /// \return Array containing the connected monitors
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::vector<Monitor> getMonitors();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    String                 name;         //!< Human-readable name of the monitor
+    Vector2i               position;     //!< Position of the monitor in the desktop, in desktop units
+    Vector2u               physicalSize; //!< Physical size of the monitor, in millimeters (zero if unknown)
+    Vector2f               dpi;          //!< Pixel density, in dots per inch (zero if unknown)
+    unsigned int           scale;        //!< Scale factor applied by the system to the contents of the monitor
+    float                  refreshRate;  //!< Refresh rate of the current mode, in Hz (zero if unknown)
+    VideoMode              desktopMode;  //!< Current video mode of the monitor, in pixels
+    std::vector<VideoMode> modes;        //!< Video modes supported by the monitor, sorted from best to worst (each size appears once, whatever its refresh rates)
+};
+
+} // namespace sf
+
+
+#endif // SFML_MONITOR_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::Monitor
+/// \ingroup window
+///
+/// sf::Monitor describes one of the displays connected to
+/// the system: its name, where it lies in the desktop, its
+/// pixel density, scale factor, refresh rate and video modes.
+///
+/// It is mostly useful on multi-head setups, to choose on
+/// which display a window goes, or which refresh rate it
+/// should be paced to. Note that the desktop mode of a monitor
+/// is expressed in pixels, while its position is expressed in
+/// desktop units, which differ when the scale factor is not 1.
+///
+/// To open a fullscreen window on a given monitor, create it
+/// with one of the modes of this monitor, ideally its desktop
+/// mode: the window goes to a monitor whose current mode is the
+/// requested one, or else to the first monitor supporting it.
+///
+/// Usage example:
+/// \code
+/// std::vector<sf::Monitor> monitors = sf::Monitor::getMonitors();
+/// for (std::size_t i = 0; i < monitors.size(); ++i)
+/// {
+///     const sf::Monitor& monitor = monitors[i];
+///     std::cout << monitor.name.toAnsiString() << ": "
+///               << monitor.desktopMode.width << "x" << monitor.desktopMode.height
+///               << " @ " << monitor.refreshRate << " Hz, scale "
+///               << monitor.scale << std::endl;
+/// }
+/// \endcode
+///
+/// \see sf::VideoMode
+///
+////////////////////////////////////////////////////////////
@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Window/ContextSettings.hpp>
+#include <SFML/Window/FrameTiming.hpp>
 #include <SFML/Window/GlResource.hpp>
 #include <SFML/Window/WindowBase.hpp>
 
@@ -223,6 +224,203 @@ public:
     ////////////////////////////////////////////////////////////
     void setFramerateLimit(unsigned int limit);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the estimated time until the next frame is presented
+    ///
+    /// On platforms where the compositor paces the window (such as
+    /// Wayland), this predicts when the next frame will be shown,
+    /// based on the timing of the previous ones. Applications can
+    /// use it to start rendering as late as possible, and thus
+    /// reduce the latency between input and display.
+    ///
+    /// \return Time until the next presentation, or Time::Zero if
+    ///         it is unknown
+    ///
+    /// \see setVerticalSyncEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getTimeUntilNextFrame() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the presentation timing of a displayed frame
+    ///
+    /// After each call to display(), the compositor eventually
+    /// tells whether and when the frame was shown. This function
+    /// returns these reports in the order they arrive, like
+    /// pollEvent() does for events. It never blocks. Only the
+    /// most recent reports are kept, so it should be called
+    /// regularly (typically once per frame) when used.
+    ///
+    /// Presentation feedback is only available on some platforms
+    /// (currently Wayland with wp_presentation); elsewhere this
+    /// function always returns false.
+    ///
+    /// \param timing Timing to be filled
+    ///
+    /// \return True if a timing was returned, false if none is available
+    ///
+    /// \see display, getTimeUntilNextFrame
+    ///
+    ////////////////////////////////////////////////////////////
+    bool pollFrameTiming(FrameTiming& timing);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allow or forbid tearing when presenting frames
+    ///
+    /// When vertical synchronization is disabled, frames are still
+    /// shown at the next vertical blank by default, which can add
+    /// up to one refresh interval of latency. Allowing tearing asks
+    /// the system to show them immediately instead (asynchronous
+    /// page flips), which gives the lowest possible latency at the
+    /// cost of visible tearing. The system is free to ignore this
+    /// hint, and usually only honors it for fullscreen windows.
+    ///
+    /// The hint has no effect while vertical synchronization is
+    /// enabled. Tearing is forbidden by default; it is only
+    /// supported on some platforms (currently Wayland, with the
+    /// tearing control protocol); elsewhere this function has no
+    /// effect.
+    ///
+    /// \param allowed True to allow tearing, false to forbid it
+    ///
+    /// \see setVerticalSyncEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTearingAllowed(bool allowed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable rendering at the native resolution
+    ///
+    /// On high density displays, the system scales the contents of
+    /// windows so that they keep a comfortable size. By default,
+    /// the window is rendered at its nominal size and then upscaled,
+    /// which is fast but blurry. When high DPI rendering is enabled,
+    /// the framebuffer of the window is allocated in physical
+    /// pixels instead, so that it can be rendered at the native
+    /// resolution of the display. A Resized event is generated
+    /// when the framebuffer size changes this way.
+    ///
+    /// getSize() and mouse coordinates stay in desktop units.
+    /// sf::RenderWindow uses them for its views, so only the OpenGL
+    /// viewport has to be sized from getFramebufferSize().
+    ///
+    /// High DPI rendering is disabled by default. It is only
+    /// supported on some platforms (currently Wayland); elsewhere
+    /// this function has no effect.
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    /// \see getFramebufferSize
+    ///
+    ////////////////////////////////////////////////////////////
+    void setHighDpiEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the resolution at which the window is rendered
+    ///
+    /// The framebuffer of the window is allocated at \a scale times
+    /// its normal size, and the system scales it back to the size
+    /// of the window when displaying it. Rendering at a reduced
+    /// resolution (a scale below 1) is a cheap way to keep a steady
+    /// frame rate on slow GPUs, since the scaling is done by the
+    /// compositor, often for free, instead of through an extra
+    /// render texture. A Resized event is generated when the
+    /// framebuffer size changes this way.
+    ///
+    /// The scale applies on top of high DPI rendering. It is 1 by
+    /// default, and is only supported on some platforms (currently
+    /// Wayland, with the viewporter protocol); elsewhere this
+    /// function has no effect.
+    ///
+    /// \param scale Ratio between the framebuffer size and its normal size
+    ///
+    /// \see getFramebufferSize, setHighDpiEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void setRenderScale(float scale);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the framebuffer of the window
+    ///
+    /// Unlike getSize(), which returns the size of the window in
+    /// the units of the desktop (those of mouse events), this
+    /// returns the size of the OpenGL framebuffer, in physical
+    /// pixels. Both are equal unless high DPI rendering is enabled
+    /// or a render scale is set.
+    /// This is the size to use for the OpenGL viewport.
+    ///
+    /// \return Size of the framebuffer, in pixels
+    ///
+    /// \see setHighDpiEnabled, setRenderScale, getSize
+    ///
+    ////////////////////////////////////////////////////////////
+    Vector2u getFramebufferSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area modified by the frame being rendered
+    ///
+    /// By default, the compositor assumes that the whole window
+    /// changes at each call to display(). Declaring the areas that
+    /// actually changed lets it recomposite only them, which saves
+    /// a lot of GPU time and memory bandwidth on mostly static
+    /// contents. The areas accumulate until the next call to
+    /// display(), which consumes them.
+    ///
+    /// This is only a hint for the compositor: the whole frame
+    /// must still be rendered, since the contents of the back
+    /// buffer are undefined after display().
+    ///
+    /// Damage is only supported on some platforms (currently
+    /// Wayland, with EGL_KHR_swap_buffers_with_damage or
+    /// EGL_EXT_swap_buffers_with_damage); elsewhere this function
+    /// has no effect.
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    /// \see display, getFramebufferSize
+    ///
+    ////////////////////////////////////////////////////////////
+    void addDamage(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area of the window as fully opaque
+    ///
+    /// Compositors must blend windows that may be translucent with
+    /// what is behind them. Declaring the areas whose pixels are
+    /// always opaque lets them skip this blending, and show a
+    /// fullscreen window directly on the screen, which reduces
+    /// power use and latency.
+    ///
+    /// The opaque region is the union of the areas declared since
+    /// the last call to resetOpaqueArea(), and takes effect with the
+    /// next call to display(). By default the whole window is
+    /// declared opaque, since SFML windows cannot be translucent.
+    /// Coordinates are in the units of getSize().
+    ///
+    /// Opaque areas are only supported on some platforms (currently
+    /// Wayland); elsewhere this function has no effect.
+    ///
+    /// \param left   X coordinate of the opaque area
+    /// \param top    Y coordinate of the opaque area
+    /// \param width  Width of the opaque area
+    /// \param height Height of the opaque area
+    ///
+    /// \see resetOpaqueArea
+    ///
+    ////////////////////////////////////////////////////////////
+    void addOpaqueArea(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restore the default opaque region of the window
+    ///
+    /// \see addOpaqueArea
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetOpaqueArea();
+
     ////////////////////////////////////////////////////////////
     /// \brief Activate or deactivate the window as the current target
     ///        for OpenGL rendering
@@ -251,6 +449,18 @@ public:
     ////////////////////////////////////////////////////////////
     void display();
 
+protected:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called before the window contents are displayed
+    ///
+    /// This function is called so that derived classes can
+    /// finish their pending rendering before the backbuffer
+    /// is shown on screen.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private:
 
     ////////////////////////////////////////////////////////////
@@ -196,6 +196,31 @@ public:
     ////////////////////////////////////////////////////////////
     bool waitEvent(Event& event);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for an event and return it, with a timeout
+    ///
+    /// This function behaves like waitEvent(Event&), except that
+    /// it gives up and returns false when no event was received
+    /// before \a timeout elapsed.
+    /// \code
+    /// sf::Event event;
+    /// while (window.waitEvent(event, sf::milliseconds(100)))
+    /// {
+    ///    // process event...
+    /// }
+    /// \endcode
+    ///
+    /// \param event   Event to be returned
+    /// \param timeout Maximum time to wait (use Time::Zero for infinity)
+    ///
+    /// \return True if an event was returned, false if the timeout
+    ///         expired or any error occurred
+    ///
+    /// \see pollEvent
+    ///
+    ////////////////////////////////////////////////////////////
+    bool waitEvent(Event& event, Time timeout);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the position of the window
     ///
@@ -338,6 +363,25 @@ public:
     ////////////////////////////////////////////////////////////
     void setKeyRepeatEnabled(bool enabled);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the coalescing of mouse motion
+    ///
+    /// High polling rate mice can report hundreds of positions
+    /// between two calls to pollEvent. If coalescing is enabled,
+    /// consecutive MouseMoved events that have not been polled
+    /// yet are merged, so that only the latest position is
+    /// reported; MouseMovedRaw deltas are summed likewise.
+    /// Other events are never merged nor reordered.
+    ///
+    /// Coalescing is disabled by default. It is only supported
+    /// on some platforms (currently Wayland); elsewhere this
+    /// function has no effect.
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMouseMoveCoalescingEnabled(bool enabled);
+
     ////////////////////////////////////////////////////////////
     /// \brief Change the joystick threshold
     ///
@@ -406,6 +450,86 @@ public:
     ////////////////////////////////////////////////////////////
     bool createVulkanSurface(const VkInstance& instance, VkSurfaceKHR& surface, const VkAllocationCallbacks* allocator = 0);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a pixel buffer to render the next frame into
+    ///
+    /// This is the software presentation path, for systems that
+    /// render on the CPU and have no (or a slow) GPU. The buffer
+    /// holds the 32-bits RGBA pixels of the whole window, row by
+    /// row, and is valid until unlockPixels is called. Its contents
+    /// are those of the last presented frame, so only the pixels
+    /// that changed need to be drawn again. When the platform can
+    /// consume RGBA pixels directly, the buffer is shared with the
+    /// compositor and no copy happens.
+    ///
+    /// The window size may change between two frames: the buffer
+    /// always has the size of the window at the time of the call,
+    /// as returned by getSize() (or sf::Window::getFramebufferSize()
+    /// if high DPI rendering is enabled). After a size change, the
+    /// contents of the buffer start over from black.
+    ///
+    /// This path doesn't need OpenGL: it keeps working on systems
+    /// without a usable EGL driver, as long as the window is an
+    /// sf::WindowBase (sf::Window creates an OpenGL context).
+    ///
+    /// Software presentation must not be mixed with OpenGL rendering
+    /// (or Vulkan) on the same window. It is only supported on some
+    /// platforms (currently Wayland); elsewhere this function
+    /// returns a null pointer.
+    ///
+    /// \return Pointer to the pixel buffer, or null if software
+    ///         presentation is not supported
+    ///
+    /// \see unlockPixels, presentPixels
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint8* lockPixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Present the frame rendered into the locked pixel buffer
+    ///
+    /// The whole window is considered modified.
+    ///
+    /// \see lockPixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void unlockPixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Present the frame rendered into the locked pixel buffer
+    ///
+    /// Only the given rectangle is considered modified, which
+    /// saves work for the compositor. Use the overload without
+    /// parameters if the modified area is not known.
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    /// \see lockPixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void unlockPixels(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Present a frame rendered on the CPU
+    ///
+    /// This function copies the whole frame into the pixel buffer
+    /// of the window and presents it. The \a pixels array must hold
+    /// 32-bits RGBA pixels of the size of the window, such as those
+    /// of a sf::Image (see lockPixels for the exact size).
+    ///
+    /// \param pixels Array of pixels to present
+    ///
+    /// \return True if the frame was presented, false if software
+    ///         presentation is not supported
+    ///
+    /// \see lockPixels
+    ///
+    ////////////////////////////////////////////////////////////
+    bool presentPixels(const Uint8* pixels);
+
 protected:
 
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_BATCHING_HPP
+#define SFML_BATCHING_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Get the primitive type that a batch must use to
+///        contain primitives of the given type
+///
+/// Strips, fans and quads can't be concatenated, so they are
+/// split into independent primitives.
+///
+/// \param type Type of the primitives to batch
+///
+/// \return Primitive type of the batch
+///
+////////////////////////////////////////////////////////////
+inline PrimitiveType getBatchPrimitiveType(PrimitiveType type)
+{
+    switch (type)
+    {
+        case Points:        return Points;
+        case Lines:
+        case LineStrip:     return Lines;
+        case Triangles:
+        case TriangleStrip:
+        case TriangleFan:
+        case Quads:         return Triangles;
+    }
+
+    assert(false);
+    return Points;
+}
+
+
+////////////////////////////////////////////////////////////
+/// \brief Append a vertex to a batch, transforming its position
+///
+/// \param batch     Vertices of the batch
+/// \param vertex    Vertex to append
+/// \param transform Transform to apply to the vertex
+/// \param identity  Is the transform the identity?
+///
+////////////////////////////////////////////////////////////
+inline void appendBatchVertex(std::vector<Vertex>& batch, const Vertex& vertex, const Transform& transform, bool identity)
+{
+    batch.push_back(vertex);
+
+    if (!identity)
+        batch.back().position = transform.transformPoint(vertex.position);
+}
+
+
+////////////////////////////////////////////////////////////
+/// \brief Append primitives to a batch, as independent primitives
+///
+/// The positions of the vertices are transformed on the way,
+/// and incomplete primitives are dropped, so that they can't
+/// shift the primitives appended after them.
+///
+/// \param batch       Vertices of the batch, in the primitive type
+///                    given by getBatchPrimitiveType(type)
+/// \param vertices    Pointer to the vertices
+/// \param vertexCount Number of vertices in the array
+/// \param type        Type of primitives to append
+/// \param transform   Transform to apply to the vertices
+///
+////////////////////////////////////////////////////////////
+inline void appendBatchVertices(std::vector<Vertex>& batch, const Vertex* vertices, std::size_t vertexCount,
+                                PrimitiveType type, const Transform& transform)
+{
+    bool identity = (transform == Transform::Identity);
+
+    switch (type)
+    {
+        case Points:
+        case Lines:
+        case Triangles:
+        {
+            std::size_t count = vertexCount;
+            if (type == Lines)
+                count -= count % 2;
+            else if (type == Triangles)
+                count -= count % 3;
+
+            for (std::size_t i = 0; i < count; ++i)
+                appendBatchVertex(batch, vertices[i], transform, identity);
+            break;
+        }
+
+        case LineStrip:
+        {
+            for (std::size_t i = 1; i < vertexCount; ++i)
+            {
+                appendBatchVertex(batch, vertices[i - 1], transform, identity);
+                appendBatchVertex(batch, vertices[i], transform, identity);
+            }
+            break;
+        }
+
+        case TriangleStrip:
+        {
+            // Keep the winding of the strip, which alternates on every triangle
+            for (std::size_t i = 2; i < vertexCount; ++i)
+            {
+                appendBatchVertex(batch, vertices[(i % 2) ? i - 1 : i - 2], transform, identity);
+                appendBatchVertex(batch, vertices[(i % 2) ? i - 2 : i - 1], transform, identity);
+                appendBatchVertex(batch, vertices[i], transform, identity);
+            }
+            break;
+        }
+
+        case TriangleFan:
+        {
+            for (std::size_t i = 2; i < vertexCount; ++i)
+            {
+                appendBatchVertex(batch, vertices[0], transform, identity);
+                appendBatchVertex(batch, vertices[i - 1], transform, identity);
+                appendBatchVertex(batch, vertices[i], transform, identity);
+            }
+            break;
+        }
+
+        case Quads:
+        {
+            for (std::size_t i = 3; i < vertexCount; i += 4)
+            {
+                appendBatchVertex(batch, vertices[i - 3], transform, identity);
+                appendBatchVertex(batch, vertices[i - 2], transform, identity);
+                appendBatchVertex(batch, vertices[i - 1], transform, identity);
+                appendBatchVertex(batch, vertices[i - 3], transform, identity);
+                appendBatchVertex(batch, vertices[i - 1], transform, identity);
+                appendBatchVertex(batch, vertices[i], transform, identity);
+            }
+            break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// \brief Build the vertices of a sprite of a sprite batch
+///
+/// The corners are the same as the ones of sf::Sprite, but
+/// transformed on the CPU; this is the fallback used when
+/// instancing is unavailable.
+///
+/// \param transform   First two rows of the 3x3 affine transform of the sprite
+/// \param textureRect Left, top, width and height of the texture rectangle
+/// \param color       Global color of the sprite
+/// \param vertices    Array of 6 vertices receiving the two triangles of the sprite
+///
+////////////////////////////////////////////////////////////
+inline void getSpriteVertices(const float* transform, const float* textureRect, const Color& color, Vertex* vertices)
+{
+    const float* t = transform;
+    const float* rect = textureRect;
+
+    float width = std::abs(rect[2]);
+    float height = std::abs(rect[3]);
+
+    Vertex corners[4] =
+    {
+        Vertex(Vector2f(t[2], t[5]), color, Vector2f(rect[0], rect[1])),
+        Vertex(Vector2f(t[1] * height + t[2], t[4] * height + t[5]), color, Vector2f(rect[0], rect[1] + rect[3])),
+        Vertex(Vector2f(t[0] * width + t[2], t[3] * width + t[5]), color, Vector2f(rect[0] + rect[2], rect[1])),
+        Vertex(Vector2f(t[0] * width + t[1] * height + t[2], t[3] * width + t[4] * height + t[5]), color, Vector2f(rect[0] + rect[2], rect[1] + rect[3]))
+    };
+
+    vertices[0] = corners[0];
+    vertices[1] = corners[1];
+    vertices[2] = corners[2];
+    vertices[3] = corners[2];
+    vertices[4] = corners[1];
+    vertices[5] = corners[3];
+}
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_BATCHING_HPP
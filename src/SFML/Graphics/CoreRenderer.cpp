@@ -0,0 +1,761 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/CoreRenderer.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/Context.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <map>
+
+
+#if !defined(GL_COMPILE_STATUS)
+    #define GL_COMPILE_STATUS 0x8B81
+#endif
+
+#if !defined(GL_LINK_STATUS)
+    #define GL_LINK_STATUS 0x8B82
+#endif
+
+#if !defined(GL_VERTEX_SHADER)
+    #define GL_VERTEX_SHADER 0x8B31
+#endif
+
+#if !defined(GL_FRAGMENT_SHADER)
+    #define GL_FRAGMENT_SHADER 0x8B30
+#endif
+
+#if !defined(GL_ARRAY_BUFFER)
+    #define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#if !defined(GL_ELEMENT_ARRAY_BUFFER)
+    #define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+
+#if !defined(GL_STREAM_DRAW)
+    #define GL_STREAM_DRAW 0x88E0
+#endif
+
+#if !defined(GL_STATIC_DRAW)
+    #define GL_STATIC_DRAW 0x88E4
+#endif
+
+#if !defined(GL_TEXTURE0)
+    #define GL_TEXTURE0 0x84C0
+#endif
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+struct CoreRenderer::ContextObjects
+{
+    GLuint      vertexArray;            //!< Vertex array object describing the vertices
+    GLuint      vertexBuffer;           //!< Buffer into which client-side vertices are uploaded when they can't be streamed
+    GLuint      quadIndexBuffer;        //!< Element buffer splitting quads into triangles
+    GLuint      indexBuffer;            //!< Buffer into which client-side indices are uploaded
+    std::size_t quadCount;              //!< Number of quads covered by the element buffer
+    GLuint      attributeBuffer;        //!< Buffer targeted by the attribute pointers, 0 if it's a vertex buffer or a stream
+    Uint64      attributeStream;        //!< Identifier of the stream buffer targeted by the attribute pointers, 0 if none
+    GLuint      program;                //!< Default shader program
+    GLint       transformLocation;      //!< Location of sf_transform in the default program
+    GLint       textureMatrixLocation;  //!< Location of sf_textureMatrix in the default program
+    GLint       textureEnabledLocation; //!< Location of sf_textureEnabled in the default program
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+namespace
+{
+    typedef void (GLAD_API_PTR *glGenVertexArraysFuncType)(GLsizei, GLuint*);
+    typedef void (GLAD_API_PTR *glBindVertexArrayFuncType)(GLuint);
+    typedef void (GLAD_API_PTR *glDeleteVertexArraysFuncType)(GLsizei, const GLuint*);
+    typedef void (GLAD_API_PTR *glGenBuffersFuncType)(GLsizei, GLuint*);
+    typedef void (GLAD_API_PTR *glBindBufferFuncType)(GLenum, GLuint);
+    typedef void (GLAD_API_PTR *glBufferDataFuncType)(GLenum, GLsizeiptr, const void*, GLenum);
+    typedef void (GLAD_API_PTR *glDeleteBuffersFuncType)(GLsizei, const GLuint*);
+    typedef void (GLAD_API_PTR *glVertexAttribPointerFuncType)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    typedef void (GLAD_API_PTR *glEnableVertexAttribArrayFuncType)(GLuint);
+    typedef GLuint (GLAD_API_PTR *glCreateShaderFuncType)(GLenum);
+    typedef void (GLAD_API_PTR *glShaderSourceFuncType)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+    typedef void (GLAD_API_PTR *glCompileShaderFuncType)(GLuint);
+    typedef void (GLAD_API_PTR *glGetShaderivFuncType)(GLuint, GLenum, GLint*);
+    typedef void (GLAD_API_PTR *glGetShaderInfoLogFuncType)(GLuint, GLsizei, GLsizei*, GLchar*);
+    typedef void (GLAD_API_PTR *glDeleteShaderFuncType)(GLuint);
+    typedef GLuint (GLAD_API_PTR *glCreateProgramFuncType)();
+    typedef void (GLAD_API_PTR *glAttachShaderFuncType)(GLuint, GLuint);
+    typedef void (GLAD_API_PTR *glBindAttribLocationFuncType)(GLuint, GLuint, const GLchar*);
+    typedef void (GLAD_API_PTR *glLinkProgramFuncType)(GLuint);
+    typedef void (GLAD_API_PTR *glGetProgramivFuncType)(GLuint, GLenum, GLint*);
+    typedef void (GLAD_API_PTR *glGetProgramInfoLogFuncType)(GLuint, GLsizei, GLsizei*, GLchar*);
+    typedef void (GLAD_API_PTR *glDeleteProgramFuncType)(GLuint);
+    typedef void (GLAD_API_PTR *glUseProgramFuncType)(GLuint);
+    typedef GLint (GLAD_API_PTR *glGetUniformLocationFuncType)(GLuint, const GLchar*);
+    typedef void (GLAD_API_PTR *glUniform1iFuncType)(GLint, GLint);
+    typedef void (GLAD_API_PTR *glUniformMatrix4fvFuncType)(GLint, GLsizei, GLboolean, const GLfloat*);
+    typedef void (GLAD_API_PTR *glActiveTextureFuncType)(GLenum);
+    typedef void (GLAD_API_PTR *glBlendFuncSeparateFuncType)(GLenum, GLenum, GLenum, GLenum);
+    typedef void (GLAD_API_PTR *glBlendEquationSeparateFuncType)(GLenum, GLenum);
+    typedef void (GLAD_API_PTR *glDrawElementsBaseVertexFuncType)(GLenum, GLsizei, GLenum, const void*, GLint);
+
+    // Core profile entry points; glad only loads the
+    // extensions that core profile contexts may not advertise
+    glGenVertexArraysFuncType         glGenVertexArraysFunc         = NULL;
+    glBindVertexArrayFuncType         glBindVertexArrayFunc         = NULL;
+    glDeleteVertexArraysFuncType      glDeleteVertexArraysFunc      = NULL;
+    glGenBuffersFuncType              glGenBuffersFunc              = NULL;
+    glBindBufferFuncType              glBindBufferFunc              = NULL;
+    glBufferDataFuncType              glBufferDataFunc              = NULL;
+    glDeleteBuffersFuncType           glDeleteBuffersFunc           = NULL;
+    glVertexAttribPointerFuncType     glVertexAttribPointerFunc     = NULL;
+    glEnableVertexAttribArrayFuncType glEnableVertexAttribArrayFunc = NULL;
+    glCreateShaderFuncType            glCreateShaderFunc            = NULL;
+    glShaderSourceFuncType            glShaderSourceFunc            = NULL;
+    glCompileShaderFuncType           glCompileShaderFunc           = NULL;
+    glGetShaderivFuncType             glGetShaderivFunc             = NULL;
+    glGetShaderInfoLogFuncType        glGetShaderInfoLogFunc        = NULL;
+    glDeleteShaderFuncType            glDeleteShaderFunc            = NULL;
+    glCreateProgramFuncType           glCreateProgramFunc           = NULL;
+    glAttachShaderFuncType            glAttachShaderFunc            = NULL;
+    glBindAttribLocationFuncType      glBindAttribLocationFunc      = NULL;
+    glLinkProgramFuncType             glLinkProgramFunc             = NULL;
+    glGetProgramivFuncType            glGetProgramivFunc            = NULL;
+    glGetProgramInfoLogFuncType       glGetProgramInfoLogFunc       = NULL;
+    glDeleteProgramFuncType           glDeleteProgramFunc           = NULL;
+    glUseProgramFuncType              glUseProgramFunc              = NULL;
+    glGetUniformLocationFuncType      glGetUniformLocationFunc      = NULL;
+    glUniform1iFuncType               glUniform1iFunc               = NULL;
+    glUniformMatrix4fvFuncType        glUniformMatrix4fvFunc        = NULL;
+    glActiveTextureFuncType           glActiveTextureFunc           = NULL;
+    glBlendFuncSeparateFuncType       glBlendFuncSeparateFunc       = NULL;
+    glBlendEquationSeparateFuncType   glBlendEquationSeparateFunc   = NULL;
+    glDrawElementsBaseVertexFuncType  glDrawElementsBaseVertexFunc  = NULL; // Optional, core since 3.2
+
+    // Default shader program, emulating the fixed-function pipeline
+    const char* vertexShaderSource =
+        "uniform mat4 sf_transform;\n"
+        "uniform mat4 sf_textureMatrix;\n"
+        "in vec2 sf_position;\n"
+        "in vec4 sf_color;\n"
+        "in vec2 sf_texCoords;\n"
+        "out vec4 sf_frontColor;\n"
+        "out vec2 sf_frontTexCoords;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = sf_transform * vec4(sf_position, 0.0, 1.0);\n"
+        "    sf_frontColor = sf_color;\n"
+        "    sf_frontTexCoords = (sf_textureMatrix * vec4(sf_texCoords, 0.0, 1.0)).xy;\n"
+        "}\n";
+
+    const char* fragmentShaderSource =
+        "uniform sampler2D sf_texture;\n"
+        "uniform bool sf_textureEnabled;\n"
+        "in vec4 sf_frontColor;\n"
+        "in vec2 sf_frontTexCoords;\n"
+        "out vec4 sf_fragColor;\n"
+        "void main()\n"
+        "{\n"
+        "    sf_fragColor = sf_textureEnabled ? sf_frontColor * texture(sf_texture, sf_frontTexCoords) : sf_frontColor;\n"
+        "}\n";
+
+    // Objects of each context, and mutex to protect them
+    typedef std::map<sf::Uint64, sf::priv::CoreRenderer::ContextObjects> ContextObjectsMap;
+    ContextObjectsMap contextObjects;
+    sf::Mutex mutex;
+
+    // Load the core profile entry points, return false if some are missing
+    bool loadFunctions()
+    {
+        static bool loaded = false;
+        static bool complete = false;
+
+        if (!loaded)
+        {
+            loaded = true;
+
+            glGenVertexArraysFunc         = reinterpret_cast<glGenVertexArraysFuncType>(sf::Context::getFunction("glGenVertexArrays"));
+            glBindVertexArrayFunc         = reinterpret_cast<glBindVertexArrayFuncType>(sf::Context::getFunction("glBindVertexArray"));
+            glDeleteVertexArraysFunc      = reinterpret_cast<glDeleteVertexArraysFuncType>(sf::Context::getFunction("glDeleteVertexArrays"));
+            glGenBuffersFunc              = reinterpret_cast<glGenBuffersFuncType>(sf::Context::getFunction("glGenBuffers"));
+            glBindBufferFunc              = reinterpret_cast<glBindBufferFuncType>(sf::Context::getFunction("glBindBuffer"));
+            glBufferDataFunc              = reinterpret_cast<glBufferDataFuncType>(sf::Context::getFunction("glBufferData"));
+            glDeleteBuffersFunc           = reinterpret_cast<glDeleteBuffersFuncType>(sf::Context::getFunction("glDeleteBuffers"));
+            glVertexAttribPointerFunc     = reinterpret_cast<glVertexAttribPointerFuncType>(sf::Context::getFunction("glVertexAttribPointer"));
+            glEnableVertexAttribArrayFunc = reinterpret_cast<glEnableVertexAttribArrayFuncType>(sf::Context::getFunction("glEnableVertexAttribArray"));
+            glCreateShaderFunc            = reinterpret_cast<glCreateShaderFuncType>(sf::Context::getFunction("glCreateShader"));
+            glShaderSourceFunc            = reinterpret_cast<glShaderSourceFuncType>(sf::Context::getFunction("glShaderSource"));
+            glCompileShaderFunc           = reinterpret_cast<glCompileShaderFuncType>(sf::Context::getFunction("glCompileShader"));
+            glGetShaderivFunc             = reinterpret_cast<glGetShaderivFuncType>(sf::Context::getFunction("glGetShaderiv"));
+            glGetShaderInfoLogFunc        = reinterpret_cast<glGetShaderInfoLogFuncType>(sf::Context::getFunction("glGetShaderInfoLog"));
+            glDeleteShaderFunc            = reinterpret_cast<glDeleteShaderFuncType>(sf::Context::getFunction("glDeleteShader"));
+            glCreateProgramFunc           = reinterpret_cast<glCreateProgramFuncType>(sf::Context::getFunction("glCreateProgram"));
+            glAttachShaderFunc            = reinterpret_cast<glAttachShaderFuncType>(sf::Context::getFunction("glAttachShader"));
+            glBindAttribLocationFunc      = reinterpret_cast<glBindAttribLocationFuncType>(sf::Context::getFunction("glBindAttribLocation"));
+            glLinkProgramFunc             = reinterpret_cast<glLinkProgramFuncType>(sf::Context::getFunction("glLinkProgram"));
+            glGetProgramivFunc            = reinterpret_cast<glGetProgramivFuncType>(sf::Context::getFunction("glGetProgramiv"));
+            glGetProgramInfoLogFunc       = reinterpret_cast<glGetProgramInfoLogFuncType>(sf::Context::getFunction("glGetProgramInfoLog"));
+            glDeleteProgramFunc           = reinterpret_cast<glDeleteProgramFuncType>(sf::Context::getFunction("glDeleteProgram"));
+            glUseProgramFunc              = reinterpret_cast<glUseProgramFuncType>(sf::Context::getFunction("glUseProgram"));
+            glGetUniformLocationFunc      = reinterpret_cast<glGetUniformLocationFuncType>(sf::Context::getFunction("glGetUniformLocation"));
+            glUniform1iFunc               = reinterpret_cast<glUniform1iFuncType>(sf::Context::getFunction("glUniform1i"));
+            glUniformMatrix4fvFunc        = reinterpret_cast<glUniformMatrix4fvFuncType>(sf::Context::getFunction("glUniformMatrix4fv"));
+            glActiveTextureFunc           = reinterpret_cast<glActiveTextureFuncType>(sf::Context::getFunction("glActiveTexture"));
+            glBlendFuncSeparateFunc       = reinterpret_cast<glBlendFuncSeparateFuncType>(sf::Context::getFunction("glBlendFuncSeparate"));
+            glBlendEquationSeparateFunc   = reinterpret_cast<glBlendEquationSeparateFuncType>(sf::Context::getFunction("glBlendEquationSeparate"));
+            glDrawElementsBaseVertexFunc  = reinterpret_cast<glDrawElementsBaseVertexFuncType>(sf::Context::getFunction("glDrawElementsBaseVertex"));
+
+            complete = glGenVertexArraysFunc && glBindVertexArrayFunc && glDeleteVertexArraysFunc &&
+                       glGenBuffersFunc && glBindBufferFunc && glBufferDataFunc && glDeleteBuffersFunc &&
+                       glVertexAttribPointerFunc && glEnableVertexAttribArrayFunc &&
+                       glCreateShaderFunc && glShaderSourceFunc && glCompileShaderFunc &&
+                       glGetShaderivFunc && glGetShaderInfoLogFunc && glDeleteShaderFunc &&
+                       glCreateProgramFunc && glAttachShaderFunc && glBindAttribLocationFunc &&
+                       glLinkProgramFunc && glGetProgramivFunc && glGetProgramInfoLogFunc &&
+                       glDeleteProgramFunc && glUseProgramFunc && glGetUniformLocationFunc &&
+                       glUniform1iFunc && glUniformMatrix4fvFunc && glActiveTextureFunc &&
+                       glBlendFuncSeparateFunc && glBlendEquationSeparateFunc;
+
+            if (!complete)
+                sf::err() << "Failed to load the OpenGL functions required to render with a core profile context" << std::endl;
+        }
+
+        return complete;
+    }
+
+    // Compile one stage of the default program
+    GLuint compileShader(GLenum type, const char* source)
+    {
+        // Core profile contexts older than 3.2 don't support GLSL 1.50
+        sf::ContextSettings settings = sf::Context::getActiveContextSettings();
+        const char* version = ((settings.majorVersion == 3) && (settings.minorVersion < 2)) ? "#version 140\n" : "#version 150\n";
+
+        const GLchar* sources[] = {version, source};
+
+        GLuint shader;
+        glCheck(shader = glCreateShaderFunc(type));
+        glCheck(glShaderSourceFunc(shader, 2, sources, NULL));
+        glCheck(glCompileShaderFunc(shader));
+
+        // Check the compile log
+        GLint success;
+        glCheck(glGetShaderivFunc(shader, GL_COMPILE_STATUS, &success));
+        if (success == GL_FALSE)
+        {
+            char log[1024];
+            glCheck(glGetShaderInfoLogFunc(shader, sizeof(log), 0, log));
+            sf::err() << "Failed to compile default shader:" << std::endl
+                      << log << std::endl;
+            glCheck(glDeleteShaderFunc(shader));
+            return 0;
+        }
+
+        return shader;
+    }
+
+    // Create the default program
+    GLuint createProgram()
+    {
+        GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+        GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+
+        if (!vertexShader || !fragmentShader)
+        {
+            if (vertexShader)
+                glCheck(glDeleteShaderFunc(vertexShader));
+
+            if (fragmentShader)
+                glCheck(glDeleteShaderFunc(fragmentShader));
+
+            return 0;
+        }
+
+        GLuint program;
+        glCheck(program = glCreateProgramFunc());
+        glCheck(glAttachShaderFunc(program, vertexShader));
+        glCheck(glAttachShaderFunc(program, fragmentShader));
+
+        // The shaders are not needed anymore once attached
+        glCheck(glDeleteShaderFunc(vertexShader));
+        glCheck(glDeleteShaderFunc(fragmentShader));
+
+        glCheck(glBindAttribLocationFunc(program, sf::priv::CoreRenderer::PositionAttribute, "sf_position"));
+        glCheck(glBindAttribLocationFunc(program, sf::priv::CoreRenderer::ColorAttribute, "sf_color"));
+        glCheck(glBindAttribLocationFunc(program, sf::priv::CoreRenderer::TexCoordsAttribute, "sf_texCoords"));
+        glCheck(glLinkProgramFunc(program));
+
+        // Check the link log
+        GLint success;
+        glCheck(glGetProgramivFunc(program, GL_LINK_STATUS, &success));
+        if (success == GL_FALSE)
+        {
+            char log[1024];
+            glCheck(glGetProgramInfoLogFunc(program, sizeof(log), 0, log));
+            sf::err() << "Failed to link default shader:" << std::endl
+                      << log << std::endl;
+            glCheck(glDeleteProgramFunc(program));
+            return 0;
+        }
+
+        return program;
+    }
+
+    // Point the vertex attributes to the array buffer currently bound, starting at the given vertex
+    void setAttributePointers(std::size_t firstVertex = 0)
+    {
+        std::size_t base = sizeof(sf::Vertex) * firstVertex;
+
+        glCheck(glVertexAttribPointerFunc(sf::priv::CoreRenderer::PositionAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(sf::Vertex), reinterpret_cast<const void*>(base + 0)));
+        glCheck(glVertexAttribPointerFunc(sf::priv::CoreRenderer::ColorAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sf::Vertex), reinterpret_cast<const void*>(base + 8)));
+        glCheck(glVertexAttribPointerFunc(sf::priv::CoreRenderer::TexCoordsAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(sf::Vertex), reinterpret_cast<const void*>(base + 12)));
+    }
+
+    // Callback that is called every time a context is destroyed
+    void contextDestroyCallback(void* /*arg*/)
+    {
+        sf::Lock lock(mutex);
+
+        ContextObjectsMap::iterator iter = contextObjects.find(sf::Context::getActiveContextId());
+
+        if (iter == contextObjects.end())
+            return;
+
+        sf::priv::CoreRenderer::ContextObjects& objects = iter->second;
+
+        glCheck(glDeleteVertexArraysFunc(1, &objects.vertexArray));
+        glCheck(glDeleteBuffersFunc(1, &objects.vertexBuffer));
+        glCheck(glDeleteBuffersFunc(1, &objects.quadIndexBuffer));
+        glCheck(glDeleteBuffersFunc(1, &objects.indexBuffer));
+
+        if (objects.program)
+            glCheck(glDeleteProgramFunc(objects.program));
+
+        contextObjects.erase(iter);
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+CoreRenderer::CoreRenderer() :
+m_contextId             (0),
+m_objects               (NULL),
+m_viewTransform         (),
+m_modelTransform        (),
+m_textureEnabled        (false),
+m_transformLocation     (-1),
+m_textureMatrixLocation (-1),
+m_textureEnabledLocation(-1)
+{
+    std::memcpy(m_textureMatrix, Transform::Identity.getMatrix(), sizeof(m_textureMatrix));
+
+    Lock lock(mutex);
+
+    // Register the context destruction callback
+    registerContextDestroyCallback(contextDestroyCallback, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool CoreRenderer::isCoreContext()
+{
+    return (Context::getActiveContextSettings().attributeFlags & ContextSettings::Core) != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CoreRenderer::setup()
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return false;
+
+    glCheck(glActiveTextureFunc(GL_TEXTURE0));
+    glCheck(glBindVertexArrayFunc(objects->vertexArray));
+
+    // Bind the default program
+    setShader(NULL);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::unbind()
+{
+    if (!getObjects())
+        return;
+
+    glCheck(glBindVertexArrayFunc(0));
+    glCheck(glBindBufferFunc(GL_ARRAY_BUFFER, 0));
+    glCheck(glUseProgramFunc(0));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setBlendMode(Uint32 colorSrcFactor, Uint32 colorDstFactor, Uint32 alphaSrcFactor, Uint32 alphaDstFactor,
+                                Uint32 colorEquation, Uint32 alphaEquation)
+{
+    if (!getObjects())
+        return;
+
+    glCheck(glBlendFuncSeparateFunc(colorSrcFactor, colorDstFactor, alphaSrcFactor, alphaDstFactor));
+    glCheck(glBlendEquationSeparateFunc(colorEquation, alphaEquation));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setViewTransform(const Transform& transform)
+{
+    m_viewTransform = transform;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setModelTransform(const Transform& transform)
+{
+    m_modelTransform = transform;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setTexture(bool enabled, const float* matrix)
+{
+    m_textureEnabled = enabled;
+    std::memcpy(m_textureMatrix, matrix, sizeof(m_textureMatrix));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setShader(const Shader* shader)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    if (shader && shader->getNativeHandle())
+    {
+        // Also binds the textures of the shader
+        Shader::bind(shader);
+
+        // The program may have been relinked since the last draw,
+        // so the locations can't be cached
+        GLuint program = static_cast<GLuint>(shader->getNativeHandle());
+        glCheck(m_transformLocation = glGetUniformLocationFunc(program, "sf_transform"));
+        glCheck(m_textureMatrixLocation = glGetUniformLocationFunc(program, "sf_textureMatrix"));
+        glCheck(m_textureEnabledLocation = glGetUniformLocationFunc(program, "sf_textureEnabled"));
+    }
+    else
+    {
+        glCheck(glUseProgramFunc(objects->program));
+
+        m_transformLocation = objects->transformLocation;
+        m_textureMatrixLocation = objects->textureMatrixLocation;
+        m_textureEnabledLocation = objects->textureEnabledLocation;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setVertices(const Vertex* vertices, std::size_t vertexCount)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    // Reallocating the storage on each draw lets the driver orphan
+    // the previous one instead of waiting until it's no longer used
+    glCheck(glBindBufferFunc(GL_ARRAY_BUFFER, objects->vertexBuffer));
+    glCheck(glBufferDataFunc(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * vertexCount), vertices, GL_STREAM_DRAW));
+
+    if (objects->attributeBuffer != objects->vertexBuffer)
+    {
+        setAttributePointers();
+        objects->attributeBuffer = objects->vertexBuffer;
+        objects->attributeStream = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setStreamVertices(Uint64 cacheId)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    // The stream buffer is already bound, only point to it if it changed
+    if (objects->attributeStream != cacheId)
+    {
+        setAttributePointers();
+        objects->attributeBuffer = 0;
+        objects->attributeStream = cacheId;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setBufferVertices()
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    setAttributePointers();
+    objects->attributeBuffer = 0;
+    objects->attributeStream = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::applyUniforms()
+{
+    if (!getObjects())
+        return;
+
+    // Apply the transforms, the program may be shared with other render targets
+    Transform transform = m_viewTransform * m_modelTransform;
+    glCheck(glUniformMatrix4fvFunc(m_transformLocation, 1, GL_FALSE, transform.getMatrix()));
+    glCheck(glUniformMatrix4fvFunc(m_textureMatrixLocation, 1, GL_FALSE, m_textureMatrix));
+    glCheck(glUniform1iFunc(m_textureEnabledLocation, m_textureEnabled ? 1 : 0));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::drawPrimitives(PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    applyUniforms();
+
+    if (type != Quads)
+    {
+        // Find the OpenGL primitive type
+        static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                       GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
+        GLenum mode = modes[type];
+
+        // Draw the primitives
+        glCheck(glDrawArrays(mode, static_cast<GLint>(firstVertex), static_cast<GLsizei>(vertexCount)));
+        return;
+    }
+
+    // Quads don't exist anymore in core profile contexts, draw them as pairs of triangles
+    std::size_t quadCount = vertexCount / 4;
+
+    if (quadCount == 0)
+        return;
+
+    // The element buffer binding is part of the vertex array object,
+    // and may have been replaced by an indexed draw since the last one
+    glCheck(glBindBufferFunc(GL_ELEMENT_ARRAY_BUFFER, objects->quadIndexBuffer));
+
+    if (quadCount > objects->quadCount)
+    {
+        objects->quadCount = std::max(quadCount, objects->quadCount * 2);
+
+        std::vector<GLuint> indices(objects->quadCount * 6);
+        for (std::size_t i = 0; i < objects->quadCount; ++i)
+        {
+            GLuint first = static_cast<GLuint>(i * 4);
+            indices[i * 6 + 0] = first + 0;
+            indices[i * 6 + 1] = first + 1;
+            indices[i * 6 + 2] = first + 2;
+            indices[i * 6 + 3] = first + 0;
+            indices[i * 6 + 4] = first + 2;
+            indices[i * 6 + 5] = first + 3;
+        }
+
+        glCheck(glBufferDataFunc(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * indices.size()), &indices[0], GL_STATIC_DRAW));
+    }
+
+    GLsizei indexCount = static_cast<GLsizei>(quadCount * 6);
+
+    if (glDrawElementsBaseVertexFunc)
+    {
+        glCheck(glDrawElementsBaseVertexFunc(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, NULL, static_cast<GLint>(firstVertex)));
+    }
+    else
+    {
+        // Without base vertex, we can only start on a quad boundary
+        const GLuint* offset = NULL;
+        glCheck(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, offset + (firstVertex / 4) * 6));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setIndices(const Uint32* indices, std::size_t indexCount)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects)
+        return;
+
+    // Core profile contexts can't read indices from client memory
+    glCheck(glBindBufferFunc(GL_ELEMENT_ARRAY_BUFFER, objects->indexBuffer));
+    glCheck(glBufferDataFunc(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Uint32) * indexCount), indices, GL_STREAM_DRAW));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::setBufferIndices(unsigned int buffer)
+{
+    if (!getObjects())
+        return;
+
+    glCheck(glBindBufferFunc(GL_ELEMENT_ARRAY_BUFFER, buffer));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderer::drawIndexedPrimitives(PrimitiveType type, std::size_t firstIndex, std::size_t indexCount, std::size_t baseVertex)
+{
+    ContextObjects* objects = getObjects();
+
+    if (!objects || (type == Quads))
+        return;
+
+    applyUniforms();
+
+    // Find the OpenGL primitive type
+    static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                   GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
+    GLenum mode = modes[type];
+
+    const GLuint* offset = NULL;
+
+    if (glDrawElementsBaseVertexFunc)
+    {
+        glCheck(glDrawElementsBaseVertexFunc(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, offset + firstIndex, static_cast<GLint>(baseVertex)));
+    }
+    else
+    {
+        // Without base vertex, the attributes must start at the first vertex instead
+        if (baseVertex)
+        {
+            setAttributePointers(baseVertex);
+            objects->attributeBuffer = 0;
+            objects->attributeStream = 0;
+        }
+
+        glCheck(glDrawElements(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, offset + firstIndex));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+CoreRenderer::ContextObjects* CoreRenderer::getObjects()
+{
+    Uint64 contextId = Context::getActiveContextId();
+
+    // The objects of a context are destroyed along with it, and
+    // context IDs are never reused, so the cache stays valid
+    if (m_objects && (contextId == m_contextId))
+        return m_objects;
+
+    Lock lock(mutex);
+
+    m_contextId = contextId;
+    m_objects = NULL;
+
+    if (!contextId || !loadFunctions())
+        return NULL;
+
+    ContextObjectsMap::iterator iter = contextObjects.find(contextId);
+
+    if (iter != contextObjects.end())
+    {
+        m_objects = &iter->second;
+        return m_objects;
+    }
+
+    // First use of this context: create its objects
+    ContextObjects objects;
+    objects.quadCount = 0;
+    objects.attributeBuffer = 0;
+    objects.attributeStream = 0;
+    objects.transformLocation = -1;
+    objects.textureMatrixLocation = -1;
+    objects.textureEnabledLocation = -1;
+
+    glCheck(glGenVertexArraysFunc(1, &objects.vertexArray));
+    glCheck(glGenBuffersFunc(1, &objects.vertexBuffer));
+    glCheck(glGenBuffersFunc(1, &objects.quadIndexBuffer));
+    glCheck(glGenBuffersFunc(1, &objects.indexBuffer));
+
+    glCheck(glBindVertexArrayFunc(objects.vertexArray));
+    glCheck(glBindBufferFunc(GL_ELEMENT_ARRAY_BUFFER, objects.quadIndexBuffer));
+    glCheck(glEnableVertexAttribArrayFunc(PositionAttribute));
+    glCheck(glEnableVertexAttribArrayFunc(ColorAttribute));
+    glCheck(glEnableVertexAttribArrayFunc(TexCoordsAttribute));
+
+    objects.program = createProgram();
+
+    if (objects.program)
+    {
+        glCheck(objects.transformLocation = glGetUniformLocationFunc(objects.program, "sf_transform"));
+        glCheck(objects.textureMatrixLocation = glGetUniformLocationFunc(objects.program, "sf_textureMatrix"));
+        glCheck(objects.textureEnabledLocation = glGetUniformLocationFunc(objects.program, "sf_textureEnabled"));
+
+        // The texture is always bound to the first unit
+        GLint textureLocation;
+        glCheck(textureLocation = glGetUniformLocationFunc(objects.program, "sf_texture"));
+        glCheck(glUseProgramFunc(objects.program));
+        glCheck(glUniform1iFunc(textureLocation, 0));
+    }
+
+    m_objects = &contextObjects.insert(std::make_pair(contextId, objects)).first->second;
+    return m_objects;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_CORERENDERER_HPP
+#define SFML_CORERENDERER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/Config.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+class Shader;
+class Vertex;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Emulation of the fixed-function pipeline used by
+///        RenderTarget within core profile contexts
+///
+/// Core profile contexts have neither matrix stacks nor
+/// client-side vertex arrays. Instead, vertices are streamed
+/// into a buffer object described by a vertex array object,
+/// and rendered by a default shader program which applies
+/// the transform and texture matrices as uniforms.
+/// Vertex array objects can't be shared, so these objects are
+/// created in each context on first use and destroyed along
+/// with the context.
+///
+////////////////////////////////////////////////////////////
+class CoreRenderer : GlResource
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Locations of the vertex attributes
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Attribute
+    {
+        PositionAttribute,  //!< vec2 sf_position
+        ColorAttribute,     //!< vec4 sf_color
+        TexCoordsAttribute  //!< vec2 sf_texCoords
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief OpenGL objects of a context
+    ///
+    ////////////////////////////////////////////////////////////
+    struct ContextObjects;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    CoreRenderer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Check whether the active context is a core profile context
+    ///
+    /// \return True if the active context has no fixed-function pipeline
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isCoreContext();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Prepare the active context for drawing
+    ///
+    /// This creates the objects of the context if needed and
+    /// binds them, along with the default program. It must be
+    /// called whenever the OpenGL states might have been
+    /// modified outside of the renderer.
+    ///
+    /// \return True if the context is ready for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    bool setup();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unbind the objects of the renderer from the active context
+    ///
+    ////////////////////////////////////////////////////////////
+    void unbind();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply a blending mode
+    ///
+    /// \param colorSrcFactor OpenGL source factor of the color channels
+    /// \param colorDstFactor OpenGL destination factor of the color channels
+    /// \param alphaSrcFactor OpenGL source factor of the alpha channel
+    /// \param alphaDstFactor OpenGL destination factor of the alpha channel
+    /// \param colorEquation  OpenGL equation of the color channels
+    /// \param alphaEquation  OpenGL equation of the alpha channel
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBlendMode(Uint32 colorSrcFactor, Uint32 colorDstFactor, Uint32 alphaSrcFactor, Uint32 alphaDstFactor,
+                      Uint32 colorEquation, Uint32 alphaEquation);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the projection transform, replacing GL_PROJECTION
+    ///
+    /// \param transform Transform of the view
+    ///
+    ////////////////////////////////////////////////////////////
+    void setViewTransform(const Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the model transform, replacing GL_MODELVIEW
+    ///
+    /// \param transform Transform of the drawn entity
+    ///
+    ////////////////////////////////////////////////////////////
+    void setModelTransform(const Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the texture state, replacing GL_TEXTURE
+    ///
+    /// The texture itself must already be bound.
+    ///
+    /// \param enabled True if a texture is bound
+    /// \param matrix  4x4 matrix to apply to texture coordinates, in column-major order
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(bool enabled, const float* matrix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind a shader, or the default program
+    ///
+    /// \param shader Shader to bind, or NULL to use the default program
+    ///
+    ////////////////////////////////////////////////////////////
+    void setShader(const Shader* shader);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload client-side vertices into the vertex buffer of the context
+    ///
+    /// This is the fallback used when the vertices couldn't
+    /// be written to a priv::VertexStream.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVertices(const Vertex* vertices, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read vertices from the buffer of a priv::VertexStream
+    ///
+    /// The buffer must be bound to GL_ARRAY_BUFFER.
+    ///
+    /// \param cacheId Identifier of the stream buffer (see priv::VertexStream::getCacheId)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setStreamVertices(Uint64 cacheId);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read vertices from the currently bound array buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBufferVertices();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the transforms and texture state to the current program
+    ///
+    /// This is done by drawPrimitives, it only needs to be
+    /// called directly before issuing other draw commands.
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyUniforms();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives from the current vertices
+    ///
+    /// \param type        Type of primitives to draw
+    /// \param firstVertex Index of the first vertex to use when drawing
+    /// \param vertexCount Number of vertices to use when drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawPrimitives(PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload client-side indices into the index buffer of the context
+    ///
+    /// \param indices    Pointer to the indices
+    /// \param indexCount Number of indices in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setIndices(const Uint32* indices, std::size_t indexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read indices from an index buffer
+    ///
+    /// \param buffer OpenGL handle of the index buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBufferIndices(unsigned int buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives from the current vertices and indices
+    ///
+    /// Quads are not supported, since the element buffer is
+    /// already used to split them into triangles.
+    ///
+    /// \param type       Type of primitives to draw
+    /// \param firstIndex Index of the first index to use when drawing
+    /// \param indexCount Number of indices to use when drawing
+    /// \param baseVertex Index of the vertex that index 0 refers to
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawIndexedPrimitives(PrimitiveType type, std::size_t firstIndex, std::size_t indexCount, std::size_t baseVertex);
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the objects of the active context
+    ///
+    /// \return Objects of the active context, or NULL if they couldn't be created
+    ///
+    ////////////////////////////////////////////////////////////
+    ContextObjects* getObjects();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Uint64          m_contextId;              //!< Context of the cached objects
+    ContextObjects* m_objects;                //!< Objects of the last context used, if still alive
+    Transform       m_viewTransform;          //!< Current projection transform
+    Transform       m_modelTransform;         //!< Current model transform
+    float           m_textureMatrix[16];      //!< Current texture matrix
+    bool            m_textureEnabled;         //!< Is a texture bound?
+    int             m_transformLocation;      //!< Location of sf_transform in the current program
+    int             m_textureMatrixLocation;  //!< Location of sf_textureMatrix in the current program
+    int             m_textureEnabledLocation; //!< Location of sf_textureEnabled in the current program
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_CORERENDERER_HPP
@@ -56,6 +56,7 @@
     // 1.1 does not support GL_STREAM_DRAW so we just define it to GL_DYNAMIC_DRAW
     #define GLEXT_vertex_buffer_object                true
     #define GLEXT_GL_ARRAY_BUFFER                     GL_ARRAY_BUFFER
+    #define GLEXT_GL_ELEMENT_ARRAY_BUFFER             GL_ELEMENT_ARRAY_BUFFER
     #define GLEXT_GL_DYNAMIC_DRAW                     GL_DYNAMIC_DRAW
     #define GLEXT_GL_STATIC_DRAW                      GL_STATIC_DRAW
     #define GLEXT_GL_STREAM_DRAW                      GL_DYNAMIC_DRAW
@@ -183,6 +184,7 @@
     // Core since 1.5 - ARB_vertex_buffer_object
     #define GLEXT_vertex_buffer_object                SF_GLAD_GL_ARB_vertex_buffer_object
     #define GLEXT_GL_ARRAY_BUFFER                     GL_ARRAY_BUFFER_ARB
+    #define GLEXT_GL_ELEMENT_ARRAY_BUFFER             GL_ELEMENT_ARRAY_BUFFER_ARB
     #define GLEXT_GL_DYNAMIC_DRAW                     GL_DYNAMIC_DRAW_ARB
     #define GLEXT_GL_READ_ONLY                        GL_READ_ONLY_ARB
     #define GLEXT_GL_STATIC_DRAW                      GL_STATIC_DRAW_ARB
@@ -235,6 +237,7 @@
 
     // Core since 2.0 - ARB_vertex_shader
     #define GLEXT_vertex_shader                       SF_GLAD_GL_ARB_vertex_shader
+    #define GLEXT_glBindAttribLocation                glBindAttribLocationARB
     #define GLEXT_GL_VERTEX_SHADER                    GL_VERTEX_SHADER_ARB
     #define GLEXT_GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS_ARB
 
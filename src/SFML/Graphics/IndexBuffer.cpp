@@ -0,0 +1,337 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/IndexBuffer.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/Context.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    sf::Mutex isAvailableMutex;
+
+    GLenum usageToGlEnum(sf::IndexBuffer::Usage usage)
+    {
+        switch (usage)
+        {
+            case sf::IndexBuffer::Static:  return GLEXT_GL_STATIC_DRAW;
+            case sf::IndexBuffer::Dynamic: return GLEXT_GL_DYNAMIC_DRAW;
+            default:                       return GLEXT_GL_STREAM_DRAW;
+        }
+    }
+
+    // The element array binding belongs to the vertex array object, and core
+    // profile contexts have none bound outside of draw calls: upload indices
+    // through the copy target there, any buffer accepts any target
+    GLenum uploadTarget()
+    {
+        return GLEXT_copy_buffer ? GLEXT_GL_COPY_WRITE_BUFFER : GLEXT_GL_ELEMENT_ARRAY_BUFFER;
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+IndexBuffer::IndexBuffer() :
+m_buffer(0),
+m_size  (0),
+m_usage (Stream)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+IndexBuffer::IndexBuffer(IndexBuffer::Usage usage) :
+m_buffer(0),
+m_size  (0),
+m_usage (usage)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+IndexBuffer::IndexBuffer(const IndexBuffer& copy) :
+GlResource(),
+m_buffer  (0),
+m_size    (0),
+m_usage   (copy.m_usage)
+{
+    if (copy.m_buffer && copy.m_size)
+    {
+        if (!create(copy.m_size))
+        {
+            err() << "Could not create index buffer for copying" << std::endl;
+            return;
+        }
+
+        if (!update(copy))
+            err() << "Could not copy index buffer" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+IndexBuffer::~IndexBuffer()
+{
+    if (m_buffer)
+    {
+        TransientContextLock contextLock;
+
+        glCheck(GLEXT_glDeleteBuffers(1, &m_buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexBuffer::create(std::size_t indexCount)
+{
+    if (!isAvailable())
+        return false;
+
+    TransientContextLock contextLock;
+
+    if (!m_buffer)
+        glCheck(GLEXT_glGenBuffers(1, &m_buffer));
+
+    if (!m_buffer)
+    {
+        err() << "Could not create index buffer, generation failed" << std::endl;
+        return false;
+    }
+
+    GLenum target = uploadTarget();
+
+    glCheck(GLEXT_glBindBuffer(target, m_buffer));
+    glCheck(GLEXT_glBufferData(target, sizeof(Uint32) * indexCount, 0, usageToGlEnum(m_usage)));
+    glCheck(GLEXT_glBindBuffer(target, 0));
+
+    m_size = indexCount;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t IndexBuffer::getIndexCount() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexBuffer::update(const Uint32* indices)
+{
+    return update(indices, m_size, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexBuffer::update(const Uint32* indices, std::size_t indexCount, unsigned int offset)
+{
+    // Sanity checks
+    if (!m_buffer)
+        return false;
+
+    if (!indices)
+        return false;
+
+    if (offset && (offset + indexCount > m_size))
+        return false;
+
+    TransientContextLock contextLock;
+
+    GLenum target = uploadTarget();
+
+    glCheck(GLEXT_glBindBuffer(target, m_buffer));
+
+    // Check if we need to resize or orphan the buffer
+    if (indexCount >= m_size)
+    {
+        glCheck(GLEXT_glBufferData(target, sizeof(Uint32) * indexCount, 0, usageToGlEnum(m_usage)));
+
+        m_size = indexCount;
+    }
+
+    glCheck(GLEXT_glBufferSubData(target, sizeof(Uint32) * offset, sizeof(Uint32) * indexCount, indices));
+
+    glCheck(GLEXT_glBindBuffer(target, 0));
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexBuffer::update(const IndexBuffer& indexBuffer)
+{
+#ifdef SFML_OPENGL_ES
+
+    (void)indexBuffer;
+
+    return false;
+
+#else
+
+    if (!m_buffer || !indexBuffer.m_buffer)
+        return false;
+
+    TransientContextLock contextLock;
+
+    // Make sure that extensions are initialized
+    sf::priv::ensureExtensionsInit();
+
+    if (GLEXT_copy_buffer)
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_READ_BUFFER, indexBuffer.m_buffer));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_WRITE_BUFFER, m_buffer));
+
+        glCheck(GLEXT_glCopyBufferSubData(GLEXT_GL_COPY_READ_BUFFER, GLEXT_GL_COPY_WRITE_BUFFER, 0, 0, sizeof(Uint32) * indexBuffer.m_size));
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_WRITE_BUFFER, 0));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_READ_BUFFER, 0));
+
+        return true;
+    }
+
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, m_buffer));
+    glCheck(GLEXT_glBufferData(GLEXT_GL_ELEMENT_ARRAY_BUFFER, sizeof(Uint32) * indexBuffer.m_size, 0, usageToGlEnum(m_usage)));
+
+    void* destination = 0;
+    glCheck(destination = GLEXT_glMapBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, GLEXT_GL_WRITE_ONLY));
+
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, indexBuffer.m_buffer));
+
+    void* source = 0;
+    glCheck(source = GLEXT_glMapBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, GLEXT_GL_READ_ONLY));
+
+    std::memcpy(destination, source, sizeof(Uint32) * indexBuffer.m_size);
+
+    GLboolean sourceResult = GL_FALSE;
+    glCheck(sourceResult = GLEXT_glUnmapBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER));
+
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, m_buffer));
+
+    GLboolean destinationResult = GL_FALSE;
+    glCheck(destinationResult = GLEXT_glUnmapBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER));
+
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, 0));
+
+    if ((sourceResult == GL_FALSE) || (destinationResult == GL_FALSE))
+        return false;
+
+    return true;
+
+#endif // SFML_OPENGL_ES
+}
+
+
+////////////////////////////////////////////////////////////
+IndexBuffer& IndexBuffer::operator =(const IndexBuffer& right)
+{
+    IndexBuffer temp(right);
+
+    swap(temp);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexBuffer::swap(IndexBuffer& right)
+{
+    std::swap(m_size,   right.m_size);
+    std::swap(m_buffer, right.m_buffer);
+    std::swap(m_usage,  right.m_usage);
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int IndexBuffer::getNativeHandle() const
+{
+    return m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexBuffer::bind(const IndexBuffer* indexBuffer)
+{
+    if (!isAvailable())
+        return;
+
+    TransientContextLock lock;
+
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ELEMENT_ARRAY_BUFFER, indexBuffer ? indexBuffer->m_buffer : 0));
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexBuffer::setUsage(IndexBuffer::Usage usage)
+{
+    m_usage = usage;
+}
+
+
+////////////////////////////////////////////////////////////
+IndexBuffer::Usage IndexBuffer::getUsage() const
+{
+    return m_usage;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexBuffer::isAvailable()
+{
+    Lock lock(isAvailableMutex);
+
+    static bool checked = false;
+    static bool available = false;
+
+    if (!checked)
+    {
+        checked = true;
+
+        TransientContextLock contextLock;
+
+        // Make sure that extensions are initialized
+        sf::priv::ensureExtensionsInit();
+
+        available = GLEXT_vertex_buffer_object;
+
+        // OpenGL ES only supports 32-bit indices through an extension
+        #ifdef SFML_OPENGL_ES
+            available = available && Context::isExtensionAvailable("GL_OES_element_index_uint");
+        #endif
+    }
+
+    return available;
+}
+
+} // namespace sf
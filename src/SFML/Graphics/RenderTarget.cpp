@@ -26,11 +26,16 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Batching.hpp>
+#include <SFML/Graphics/CoreRenderer.hpp>
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/IndexBuffer.hpp>
 #include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/SpriteBatch.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/VertexStream.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/Window/Context.hpp>
 #include <SFML/System/Mutex.hpp>
@@ -39,6 +44,7 @@
 #include <cassert>
 #include <iostream>
 #include <algorithm>
+#include <vector>
 #include <map>
 
 
@@ -126,24 +132,38 @@ namespace sf
 {
 ////////////////////////////////////////////////////////////
 RenderTarget::RenderTarget() :
-m_defaultView(),
-m_view       (),
-m_cache      (),
-m_id         (0)
+m_defaultView    (),
+m_view           (),
+m_cache          (),
+m_id             (0),
+m_batchingEnabled(false),
+m_batchVertices  (),
+m_batchType      (Points),
+m_batchStates    (),
+m_batchTextureId (0),
+m_coreRenderer   (NULL),
+m_vertexStream   (NULL)
 {
     m_cache.glStatesSet = false;
+    m_cache.coreProfile = false;
+    m_cache.streamId = 0;
 }
 
 
 ////////////////////////////////////////////////////////////
 RenderTarget::~RenderTarget()
 {
+    delete m_coreRenderer;
+    delete m_vertexStream;
 }
 
 
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    // Pending draws would be overwritten anyway
+    m_batchVertices.clear();
+
     if (isActive(m_id) || setActive(true))
     {
         // Unbind texture to fix RenderTexture preventing clear
@@ -158,6 +178,9 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Pending draws must be rendered with the previous view
+    flush();
+
     m_view = view;
     m_cache.viewChanged = true;
 }
@@ -191,6 +214,13 @@ IntRect RenderTarget::getViewport(const View& view) const
 }
 
 
+////////////////////////////////////////////////////////////
+Vector2u RenderTarget::getFramebufferSize() const
+{
+    return getSize();
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2f RenderTarget::mapPixelToCoords(const Vector2i& point) const
 {
@@ -259,122 +289,277 @@ void RenderTarget::draw(const Vertex* vertices, std::size_t vertexCount,
         }
     #endif
 
-    if (isActive(m_id) || setActive(true))
+    // Textures attached to a RenderTexture must be rebound on each draw, so they are never batched
+    if (m_batchingEnabled && !(states.texture && states.texture->m_fboAttachment))
     {
-        // Check if the vertex count is low enough so that we can pre-transform them
-        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+        batchVertices(vertices, vertexCount, type, states);
+    }
+    else
+    {
+        flush();
+        drawVertices(vertices, vertexCount, type, states);
+    }
+}
 
-        if (useVertexCache)
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, const RenderStates& states)
+{
+    draw(vertexBuffer, 0, vertexBuffer.getVertexCount(), states);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex,
+                        std::size_t vertexCount, const RenderStates& states)
+{
+    // VertexBuffer not supported?
+    if (!VertexBuffer::isAvailable())
+    {
+        err() << "sf::VertexBuffer is not available, drawing skipped" << std::endl;
+        return;
+    }
+
+    // Sanity check
+    if (firstVertex > vertexBuffer.getVertexCount())
+        return;
+
+    // Clamp vertexCount to something that makes sense
+    vertexCount = std::min(vertexCount, vertexBuffer.getVertexCount() - firstVertex);
+
+    // Nothing to draw?
+    if (!vertexCount || !vertexBuffer.getNativeHandle())
+        return;
+
+    // GL_QUADS is unavailable on OpenGL ES
+    #ifdef SFML_OPENGL_ES
+        if (vertexBuffer.getPrimitiveType() == Quads)
         {
-            // Pre-transform the vertices and store them into the vertex cache
-            for (std::size_t i = 0; i < vertexCount; ++i)
-            {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
-            }
+            err() << "sf::Quads primitive type is not supported on OpenGL ES platforms, drawing skipped" << std::endl;
+            return;
         }
+    #endif
 
-        setupDraw(useVertexCache, states);
+    // Vertex buffers are drawn directly, after the pending draws
+    flush();
 
-        // Check if texture coordinates array is needed, and update client state accordingly
-        bool enableTexCoordsArray = (states.texture || states.shader);
-        if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+    if (isActive(m_id) || setActive(true))
+    {
+        setupDraw(false, states);
+
+        // Bind vertex buffer
+        VertexBuffer::bind(&vertexBuffer);
+
+        if (m_cache.coreProfile)
         {
-            if (enableTexCoordsArray)
+            m_coreRenderer->setBufferVertices();
+        }
+        else
+        {
+            // Always enable texture coordinates
+            if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
                 glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
-            else
-                glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
+            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
+        }
+
+        drawPrimitives(vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
+
+        // Unbind vertex buffer
+        VertexBuffer::bind(NULL);
+
+        cleanupDraw(states);
+
+        // Update the cache
+        m_cache.useVertexCache = false;
+        m_cache.texCoordsArrayEnabled = true;
+        m_cache.streamId = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const Vertex* vertices, std::size_t vertexCount,
+                        const Uint32* indices, std::size_t indexCount,
+                        PrimitiveType type, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!vertices || !vertexCount || !indices || !indexCount)
+        return;
+
+    // Indices past the end of the array would make the graphics card read
+    // whatever lies behind the vertices (or the stream buffer)
+    for (std::size_t i = 0; i < indexCount; ++i)
+    {
+        if (indices[i] >= vertexCount)
+        {
+            err() << "Index " << indices[i] << " is out of range (" << vertexCount << " vertices), drawing skipped" << std::endl;
+            return;
         }
+    }
 
-        // If we switch between non-cache and cache mode or enable texture
-        // coordinates we need to set up the pointers to the vertices' components
-        if (!m_cache.enable || !useVertexCache || !m_cache.useVertexCache)
+    // GL_QUADS is unavailable on OpenGL ES, which only supports 32-bit indices through an extension
+    #ifdef SFML_OPENGL_ES
+        if (type == Quads)
         {
-            const char* data = reinterpret_cast<const char*>(vertices);
+            err() << "sf::Quads primitive type is not supported on OpenGL ES platforms, drawing skipped" << std::endl;
+            return;
+        }
 
-            // If we pre-transform the vertices, we must use our internal vertex cache
-            if (useVertexCache)
-                data = reinterpret_cast<const char*>(m_cache.vertexCache);
+        if (!IndexBuffer::isAvailable())
+        {
+            err() << "32-bit indices are not supported on this OpenGL ES platform, drawing skipped" << std::endl;
+            return;
+        }
+    #endif
 
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
-            if (enableTexCoordsArray)
-                glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+    // Indexed draws are issued directly, after the pending draws
+    flush();
+
+    if (isActive(m_id) || setActive(true))
+    {
+        // Shared vertices are transformed once by the graphics card, so the vertex cache is never used
+        setupDraw(false, states);
+
+        if (m_cache.coreProfile && (type == Quads))
+        {
+            err() << "sf::Quads primitive type is not supported for indexed draws in core profile contexts, drawing skipped" << std::endl;
+            cleanupDraw(states);
+            return;
         }
-        else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
+
+        // Stream the vertices, like for non-indexed draws
+        if (!m_vertexStream)
+            m_vertexStream = new priv::VertexStream;
+
+        std::size_t firstVertex = 0;
+        bool streamed = m_vertexStream->write(vertices, vertexCount, firstVertex);
+
+        // Check if texture coordinates array is needed
+        bool enableTexCoordsArray = (states.texture || states.shader);
+
+        if (m_cache.coreProfile)
         {
-            // If we enter this block, we are already using our internal vertex cache
-            const char* data = reinterpret_cast<const char*>(m_cache.vertexCache);
+            if (streamed)
+                m_coreRenderer->setStreamVertices(m_vertexStream->getCacheId());
+            else
+                m_coreRenderer->setVertices(vertices, vertexCount);
 
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+            m_coreRenderer->setIndices(indices, indexCount);
+            m_coreRenderer->drawIndexedPrimitives(type, 0, indexCount, streamed ? firstVertex : 0);
+        }
+        else
+        {
+            // Update client state according to the need for texture coordinates
+            if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+            {
+                if (enableTexCoordsArray)
+                    glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+                else
+                    glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+            }
+
+            // The indices are relative to the first vertex, so the pointers must always start there
+            std::size_t base = streamed ? sizeof(Vertex) * firstVertex : reinterpret_cast<std::size_t>(vertices);
+
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(base + 0)));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(base + 8)));
+            if (enableTexCoordsArray)
+                glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(base + 12)));
+
+            drawIndexedPrimitives(type, indices, indexCount);
         }
 
-        drawPrimitives(type, 0, vertexCount);
         cleanupDraw(states);
 
-        // Update the cache
-        m_cache.useVertexCache = useVertexCache;
+        // Update the cache; the pointers don't target the start of the stream buffer
+        m_cache.useVertexCache = false;
+        m_cache.streamId = 0;
         m_cache.texCoordsArrayEnabled = enableTexCoordsArray;
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-void RenderTarget::draw(const VertexBuffer& vertexBuffer, const RenderStates& states)
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, const IndexBuffer& indexBuffer, const RenderStates& states)
 {
-    draw(vertexBuffer, 0, vertexBuffer.getVertexCount(), states);
+    draw(vertexBuffer, indexBuffer, 0, indexBuffer.getIndexCount(), states);
 }
 
 
 ////////////////////////////////////////////////////////////
-void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex,
-                        std::size_t vertexCount, const RenderStates& states)
+void RenderTarget::draw(const VertexBuffer& vertexBuffer, const IndexBuffer& indexBuffer,
+                        std::size_t firstIndex, std::size_t indexCount, const RenderStates& states)
 {
-    // VertexBuffer not supported?
-    if (!VertexBuffer::isAvailable())
+    // VertexBuffer or IndexBuffer not supported?
+    if (!VertexBuffer::isAvailable() || !IndexBuffer::isAvailable())
     {
-        err() << "sf::VertexBuffer is not available, drawing skipped" << std::endl;
+        err() << "sf::IndexBuffer is not available, drawing skipped" << std::endl;
         return;
     }
 
     // Sanity check
-    if (firstVertex > vertexBuffer.getVertexCount())
+    if (firstIndex > indexBuffer.getIndexCount())
         return;
 
-    // Clamp vertexCount to something that makes sense
-    vertexCount = std::min(vertexCount, vertexBuffer.getVertexCount() - firstVertex);
+    // Clamp indexCount to something that makes sense
+    indexCount = std::min(indexCount, indexBuffer.getIndexCount() - firstIndex);
 
     // Nothing to draw?
-    if (!vertexCount || !vertexBuffer.getNativeHandle())
+    if (!indexCount || !vertexBuffer.getNativeHandle() || !indexBuffer.getNativeHandle())
         return;
 
+    PrimitiveType type = vertexBuffer.getPrimitiveType();
+
     // GL_QUADS is unavailable on OpenGL ES
     #ifdef SFML_OPENGL_ES
-        if (vertexBuffer.getPrimitiveType() == Quads)
+        if (type == Quads)
         {
             err() << "sf::Quads primitive type is not supported on OpenGL ES platforms, drawing skipped" << std::endl;
             return;
         }
     #endif
 
+    // Indexed draws are issued directly, after the pending draws
+    flush();
+
     if (isActive(m_id) || setActive(true))
     {
         setupDraw(false, states);
 
+        if (m_cache.coreProfile && (type == Quads))
+        {
+            err() << "sf::Quads primitive type is not supported for indexed draws in core profile contexts, drawing skipped" << std::endl;
+            cleanupDraw(states);
+            return;
+        }
+
         // Bind vertex buffer
         VertexBuffer::bind(&vertexBuffer);
 
-        // Always enable texture coordinates
-        if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
-            glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+        if (m_cache.coreProfile)
+        {
+            // The element buffer binding belongs to the vertex array object of the renderer
+            m_coreRenderer->setBufferVertices();
+            m_coreRenderer->setBufferIndices(indexBuffer.getNativeHandle());
+            m_coreRenderer->drawIndexedPrimitives(type, firstIndex, indexCount, 0);
+        }
+        else
+        {
+            // Always enable texture coordinates
+            if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
+                glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
 
-        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
-        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
-        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
+            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
 
-        drawPrimitives(vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
+            IndexBuffer::bind(&indexBuffer);
+            drawIndexedPrimitives(type, reinterpret_cast<const void*>(sizeof(Uint32) * firstIndex), indexCount);
+            IndexBuffer::bind(NULL);
+        }
 
         // Unbind vertex buffer
         VertexBuffer::bind(NULL);
@@ -384,7 +569,116 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
         // Update the cache
         m_cache.useVertexCache = false;
         m_cache.texCoordsArrayEnabled = true;
+        m_cache.streamId = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const SpriteBatch& spriteBatch, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (!spriteBatch.getTexture() || !spriteBatch.getSpriteCount())
+        return;
+
+    RenderStates batchStates(states);
+    batchStates.texture = spriteBatch.getTexture();
+
+    const Shader* instancingShader = NULL;
+
+    // The built-in shader is required to read the per-instance data
+    if (!states.shader && SpriteBatch::isInstancingAvailable())
+    {
+        // Instances are drawn directly, after the pending draws
+        flush();
+
+        if (!isActive(m_id) && !setActive(true))
+            return;
+
+        // We need to know the kind of context to choose the shader
+        if (!m_cache.glStatesSet)
+            resetGLStates();
+
+        instancingShader = spriteBatch.prepareInstancing(m_cache.coreProfile);
+    }
+
+    if (!instancingShader)
+    {
+        // Fall back to building the vertices of the sprites on the CPU
+        const std::vector<Vertex>& vertices = spriteBatch.getVertices();
+        draw(&vertices[0], vertices.size(), Triangles, batchStates);
+        return;
+    }
+
+    batchStates.shader = instancingShader;
+    setupDraw(false, batchStates);
+
+    // Bind the unit quad, each instance draws it once
+    VertexBuffer::bind(&spriteBatch.m_quad);
+
+    if (m_cache.coreProfile)
+    {
+        m_coreRenderer->setBufferVertices();
+        m_coreRenderer->applyUniforms();
     }
+    else
+    {
+        // Always enable texture coordinates
+        if (!m_cache.enable || !m_cache.texCoordsArrayEnabled)
+            glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+
+        glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(0)));
+        glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
+        glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
+    }
+
+    spriteBatch.drawInstances();
+
+    // Unbind vertex buffer
+    VertexBuffer::bind(NULL);
+
+    cleanupDraw(batchStates);
+
+    // Update the cache
+    m_cache.useVertexCache = false;
+    m_cache.texCoordsArrayEnabled = true;
+    m_cache.streamId = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    m_batchingEnabled = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_batchingEnabled;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    if (m_batchVertices.empty())
+        return;
+
+    // Take the pending vertices out of the batch first, so that the
+    // state changes performed while drawing them can't flush it again
+    std::vector<Vertex> vertices;
+    vertices.swap(m_batchVertices);
+
+    drawVertices(&vertices[0], vertices.size(), m_batchType, m_batchStates);
+
+    // Give the storage back to the batch, to avoid reallocating it on each frame
+    vertices.clear();
+    m_batchVertices.swap(vertices);
 }
 
 
@@ -431,6 +725,8 @@ bool RenderTarget::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    flush();
+
     if (isActive(m_id) || setActive(true))
     {
         #ifdef SFML_DEBUG
@@ -444,16 +740,20 @@ void RenderTarget::pushGLStates()
             }
         #endif
 
-        #ifndef SFML_OPENGL_ES
-            glCheck(glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS));
-            glCheck(glPushAttrib(GL_ALL_ATTRIB_BITS));
-        #endif
-        glCheck(glMatrixMode(GL_MODELVIEW));
-        glCheck(glPushMatrix());
-        glCheck(glMatrixMode(GL_PROJECTION));
-        glCheck(glPushMatrix());
-        glCheck(glMatrixMode(GL_TEXTURE));
-        glCheck(glPushMatrix());
+        // Core profile contexts have neither attribute nor matrix stacks
+        if (!priv::CoreRenderer::isCoreContext())
+        {
+            #ifndef SFML_OPENGL_ES
+                glCheck(glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS));
+                glCheck(glPushAttrib(GL_ALL_ATTRIB_BITS));
+            #endif
+            glCheck(glMatrixMode(GL_MODELVIEW));
+            glCheck(glPushMatrix());
+            glCheck(glMatrixMode(GL_PROJECTION));
+            glCheck(glPushMatrix());
+            glCheck(glMatrixMode(GL_TEXTURE));
+            glCheck(glPushMatrix());
+        }
     }
 
     resetGLStates();
@@ -463,18 +763,31 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flush();
+
     if (isActive(m_id) || setActive(true))
     {
-        glCheck(glMatrixMode(GL_PROJECTION));
-        glCheck(glPopMatrix());
-        glCheck(glMatrixMode(GL_MODELVIEW));
-        glCheck(glPopMatrix());
-        glCheck(glMatrixMode(GL_TEXTURE));
-        glCheck(glPopMatrix());
-        #ifndef SFML_OPENGL_ES
-            glCheck(glPopClientAttrib());
-            glCheck(glPopAttrib());
-        #endif
+        if (priv::CoreRenderer::isCoreContext())
+        {
+            // The states can't be restored, at least leave our objects unbound
+            if (m_coreRenderer)
+                m_coreRenderer->unbind();
+
+            m_cache.enable = false;
+        }
+        else
+        {
+            glCheck(glMatrixMode(GL_PROJECTION));
+            glCheck(glPopMatrix());
+            glCheck(glMatrixMode(GL_MODELVIEW));
+            glCheck(glPopMatrix());
+            glCheck(glMatrixMode(GL_TEXTURE));
+            glCheck(glPopMatrix());
+            #ifndef SFML_OPENGL_ES
+                glCheck(glPopClientAttrib());
+                glCheck(glPopAttrib());
+            #endif
+        }
     }
 }
 
@@ -482,6 +795,8 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
+    flush();
+
     // Check here to make sure a context change does not happen after activate(true)
     bool shaderAvailable = Shader::isAvailable();
     bool vertexBufferAvailable = VertexBuffer::isAvailable();
@@ -497,31 +812,48 @@ void RenderTarget::resetGLStates()
         // Make sure that extensions are initialized
         priv::ensureExtensionsInit();
 
-        // Make sure that the texture unit which is active is the number 0
-        if (GLEXT_multitexture)
+        // Core profile contexts have no fixed-function pipeline, it is emulated with shaders
+        m_cache.coreProfile = priv::CoreRenderer::isCoreContext();
+
+        if (m_cache.coreProfile)
         {
-            glCheck(GLEXT_glClientActiveTexture(GLEXT_GL_TEXTURE0));
-            glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+            if (!m_coreRenderer)
+                m_coreRenderer = new priv::CoreRenderer;
+
+            // Define the default OpenGL states
+            glCheck(glDisable(GL_CULL_FACE));
+            glCheck(glDisable(GL_DEPTH_TEST));
+            glCheck(glEnable(GL_BLEND));
+            m_coreRenderer->setup();
         }
+        else
+        {
+            // Make sure that the texture unit which is active is the number 0
+            if (GLEXT_multitexture)
+            {
+                glCheck(GLEXT_glClientActiveTexture(GLEXT_GL_TEXTURE0));
+                glCheck(GLEXT_glActiveTexture(GLEXT_GL_TEXTURE0));
+            }
 
-        // Define the default OpenGL states
-        glCheck(glDisable(GL_CULL_FACE));
-        glCheck(glDisable(GL_LIGHTING));
-        glCheck(glDisable(GL_DEPTH_TEST));
-        glCheck(glDisable(GL_ALPHA_TEST));
-        glCheck(glEnable(GL_TEXTURE_2D));
-        glCheck(glEnable(GL_BLEND));
-        glCheck(glMatrixMode(GL_MODELVIEW));
-        glCheck(glLoadIdentity());
-        glCheck(glEnableClientState(GL_VERTEX_ARRAY));
-        glCheck(glEnableClientState(GL_COLOR_ARRAY));
-        glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+            // Define the default OpenGL states
+            glCheck(glDisable(GL_CULL_FACE));
+            glCheck(glDisable(GL_LIGHTING));
+            glCheck(glDisable(GL_DEPTH_TEST));
+            glCheck(glDisable(GL_ALPHA_TEST));
+            glCheck(glEnable(GL_TEXTURE_2D));
+            glCheck(glEnable(GL_BLEND));
+            glCheck(glMatrixMode(GL_MODELVIEW));
+            glCheck(glLoadIdentity());
+            glCheck(glEnableClientState(GL_VERTEX_ARRAY));
+            glCheck(glEnableClientState(GL_COLOR_ARRAY));
+            glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+        }
         m_cache.glStatesSet = true;
 
         // Apply the default SFML states
         applyBlendMode(BlendAlpha);
         applyTexture(NULL);
-        if (shaderAvailable)
+        if (shaderAvailable || m_cache.coreProfile)
             applyShader(NULL);
 
         if (vertexBufferAvailable)
@@ -530,6 +862,7 @@ void RenderTarget::resetGLStates()
         m_cache.texCoordsArrayEnabled = true;
 
         m_cache.useVertexCache = false;
+        m_cache.streamId = 0;
 
         // Set the default view
         setView(getView());
@@ -558,17 +891,30 @@ void RenderTarget::initialize()
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
-    // Set the viewport
-    IntRect viewport = getViewport(m_view);
-    int top = getSize().y - (viewport.top + viewport.height);
+    // Set the viewport, in framebuffer pixels rather than in the units of getSize()
+    float width  = static_cast<float>(getFramebufferSize().x);
+    float height = static_cast<float>(getFramebufferSize().y);
+    const FloatRect& ratio = m_view.getViewport();
+    IntRect viewport(static_cast<int>(0.5f + width  * ratio.left),
+                     static_cast<int>(0.5f + height * ratio.top),
+                     static_cast<int>(0.5f + width  * ratio.width),
+                     static_cast<int>(0.5f + height * ratio.height));
+    int top = getFramebufferSize().y - (viewport.top + viewport.height);
     glCheck(glViewport(viewport.left, top, viewport.width, viewport.height));
 
     // Set the projection matrix
-    glCheck(glMatrixMode(GL_PROJECTION));
-    glCheck(glLoadMatrixf(m_view.getTransform().getMatrix()));
+    if (m_cache.coreProfile)
+    {
+        m_coreRenderer->setViewTransform(m_view.getTransform());
+    }
+    else
+    {
+        glCheck(glMatrixMode(GL_PROJECTION));
+        glCheck(glLoadMatrixf(m_view.getTransform().getMatrix()));
 
-    // Go back to model-view mode
-    glCheck(glMatrixMode(GL_MODELVIEW));
+        // Go back to model-view mode
+        glCheck(glMatrixMode(GL_MODELVIEW));
+    }
 
     m_cache.viewChanged = false;
 }
@@ -577,6 +923,18 @@ void RenderTarget::applyCurrentView()
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyBlendMode(const BlendMode& mode)
 {
+    // Core profile contexts always support separate functions and equations
+    if (m_cache.coreProfile)
+    {
+        m_coreRenderer->setBlendMode(
+            factorToGlConstant(mode.colorSrcFactor), factorToGlConstant(mode.colorDstFactor),
+            factorToGlConstant(mode.alphaSrcFactor), factorToGlConstant(mode.alphaDstFactor),
+            equationToGlConstant(mode.colorEquation), equationToGlConstant(mode.alphaEquation));
+
+        m_cache.lastBlendMode = mode;
+        return;
+    }
+
     // Apply the blend mode, falling back to the non-separate versions if necessary
     if (GLEXT_blend_func_separate)
     {
@@ -625,6 +983,12 @@ void RenderTarget::applyBlendMode(const BlendMode& mode)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyTransform(const Transform& transform)
 {
+    if (m_cache.coreProfile)
+    {
+        m_coreRenderer->setModelTransform(transform);
+        return;
+    }
+
     // No need to call glMatrixMode(GL_MODELVIEW), it is always the
     // current mode (for optimization purpose, since it's the most used)
     if (transform == Transform::Identity)
@@ -639,6 +1003,21 @@ void RenderTarget::applyTexture(const Texture* texture)
 {
     Texture::bind(texture, Texture::Pixels);
 
+    // Core profile contexts have no texture matrix, the shader applies it instead
+    if (m_cache.coreProfile)
+    {
+        if (texture && texture->m_texture)
+        {
+            float matrix[16];
+            texture->getTextureMatrix(Texture::Pixels, matrix);
+            m_coreRenderer->setTexture(true, matrix);
+        }
+        else
+        {
+            m_coreRenderer->setTexture(false, Transform::Identity.getMatrix());
+        }
+    }
+
     m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
 }
 
@@ -646,7 +1025,11 @@ void RenderTarget::applyTexture(const Texture* texture)
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyShader(const Shader* shader)
 {
-    Shader::bind(shader);
+    // In core profile contexts, drawing without shader uses the default program
+    if (m_cache.coreProfile)
+        m_coreRenderer->setShader(shader);
+    else
+        Shader::bind(shader);
 }
 
 
@@ -657,11 +1040,15 @@ void RenderTarget::setupDraw(bool useVertexCache, const RenderStates& states)
     if (!m_cache.glStatesSet)
         resetGLStates();
 
+    // Our objects may have been unbound since the last draw
+    else if (m_cache.coreProfile && !m_cache.enable)
+        m_coreRenderer->setup();
+
     if (useVertexCache)
     {
         // Since vertices are transformed, we must use an identity transform to render them
         if (!m_cache.enable || !m_cache.useVertexCache)
-            glCheck(glLoadIdentity());
+            applyTransform(Transform::Identity);
     }
     else
     {
@@ -703,6 +1090,12 @@ void RenderTarget::setupDraw(bool useVertexCache, const RenderStates& states)
 ////////////////////////////////////////////////////////////
 void RenderTarget::drawPrimitives(PrimitiveType type, std::size_t firstVertex, std::size_t vertexCount)
 {
+    if (m_cache.coreProfile)
+    {
+        m_coreRenderer->drawPrimitives(type, firstVertex, vertexCount);
+        return;
+    }
+
     // Find the OpenGL primitive type
     static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
                                    GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_QUADS};
@@ -713,6 +1106,19 @@ void RenderTarget::drawPrimitives(PrimitiveType type, std::size_t firstVertex, s
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::drawIndexedPrimitives(PrimitiveType type, const void* indices, std::size_t indexCount)
+{
+    // Find the OpenGL primitive type
+    static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
+                                   GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_QUADS};
+    GLenum mode = modes[type];
+
+    // Draw the primitives
+    glCheck(glDrawElements(mode, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, indices));
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::cleanupDraw(const RenderStates& states)
 {
@@ -729,6 +1135,123 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
     m_cache.enable = true;
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawVertices(const Vertex* vertices, std::size_t vertexCount,
+                                PrimitiveType type, const RenderStates& states)
+{
+    if (isActive(m_id) || setActive(true))
+    {
+        // Check if the vertex count is low enough so that we can pre-transform them
+        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+
+        if (useVertexCache)
+        {
+            // Pre-transform the vertices and store them into the vertex cache
+            for (std::size_t i = 0; i < vertexCount; ++i)
+            {
+                Vertex& vertex = m_cache.vertexCache[i];
+                vertex.position = states.transform * vertices[i].position;
+                vertex.color = vertices[i].color;
+                vertex.texCoords = vertices[i].texCoords;
+            }
+        }
+
+        setupDraw(useVertexCache, states);
+
+        // If we pre-transform the vertices, we must use our internal vertex cache
+        const Vertex* data = useVertexCache ? m_cache.vertexCache : vertices;
+
+        // Stream the vertices into a buffer object, so that the driver doesn't
+        // have to copy them from client memory before returning from the draw
+        if (!m_vertexStream)
+            m_vertexStream = new priv::VertexStream;
+
+        std::size_t firstVertex = 0;
+        bool streamed = m_vertexStream->write(data, vertexCount, firstVertex);
+        Uint64 streamId = streamed ? m_vertexStream->getCacheId() : 0;
+
+        // Check if texture coordinates array is needed
+        bool enableTexCoordsArray = (states.texture || states.shader);
+
+        if (m_cache.coreProfile)
+        {
+            // There are no client-side arrays in core profile contexts
+            if (streamed)
+                m_coreRenderer->setStreamVertices(streamId);
+            else
+                m_coreRenderer->setVertices(data, vertexCount);
+        }
+        else
+        {
+            // Update client state according to the need for texture coordinates
+            if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+            {
+                if (enableTexCoordsArray)
+                    glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+                else
+                    glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+            }
+
+            // Streamed vertices are read from the bound buffer, at an offset from its start
+            std::size_t base = streamed ? 0 : reinterpret_cast<std::size_t>(data);
+
+            // If we switch to another array or enable texture coordinates
+            // we need to set up the pointers to the vertices' components;
+            // the stream buffer and the vertex cache never move
+            bool sameArray = streamed || (useVertexCache && m_cache.useVertexCache);
+
+            if (!m_cache.enable || (streamId != m_cache.streamId) || !sameArray)
+            {
+                glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(base + 0)));
+                glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(base + 8)));
+                if (enableTexCoordsArray)
+                    glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(base + 12)));
+            }
+            else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
+            {
+                // If we enter this block, we are still using the same array
+                glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(base + 12)));
+            }
+        }
+
+        drawPrimitives(type, firstVertex, vertexCount);
+        cleanupDraw(states);
+
+        // Update the cache
+        m_cache.useVertexCache = useVertexCache;
+        m_cache.streamId = streamId;
+        m_cache.texCoordsArrayEnabled = enableTexCoordsArray;
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::batchVertices(const Vertex* vertices, std::size_t vertexCount,
+                                 PrimitiveType type, const RenderStates& states)
+{
+    PrimitiveType batchType = priv::getBatchPrimitiveType(type);
+    Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
+
+    // Start a new batch if the render states differ from the pending ones
+    if ((batchType != m_batchType) ||
+        (states.texture != m_batchStates.texture) ||
+        (textureId != m_batchTextureId) ||
+        (states.shader != m_batchStates.shader) ||
+        (states.blendMode != m_batchStates.blendMode))
+    {
+        flush();
+
+        m_batchType = batchType;
+        m_batchStates = RenderStates(states.blendMode, Transform::Identity, states.texture, states.shader);
+        m_batchTextureId = textureId;
+    }
+
+    priv::appendBatchVertices(m_batchVertices, vertices, vertexCount, type, states.transform);
+}
+
 } // namespace sf
 
 
@@ -767,4 +1290,28 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
 //   do is that we avoid setting a null shader if there was
 //   already none for the previous draw.
 //
+// * Core profile
+//   The fixed-function states above are emulated by
+//   priv::CoreRenderer: the matrices are kept on the CPU and
+//   uploaded as uniforms right before each draw, since the
+//   default program is shared by all targets of a context.
+//
+// * Batching
+//   When enabled, the draws of vertex arrays are not issued
+//   immediately: their vertices are pre-transformed like with
+//   the vertex cache and appended to a single array, as long as
+//   the texture, shader and blend mode don't change. Strips,
+//   fans and quads are converted to independent lines and
+//   triangles, so that any number of them can be concatenated.
+//   The whole array is drawn with one call when the states
+//   change, or when something else needs the target to be up
+//   to date (view change, deactivation, display, ...).
+//
+// * Vertex streaming
+//   Vertex arrays are not drawn from client memory, which the
+//   driver would have to copy before returning: they are
+//   appended to a per-context ring buffer (priv::VertexStream)
+//   and drawn from there at an offset. The vertex pointers are
+//   only set up again when that buffer is reallocated.
+//
 ////////////////////////////////////////////////////////////
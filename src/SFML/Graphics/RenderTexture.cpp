@@ -28,6 +28,8 @@
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderTextureImplFBO.hpp>
 #include <SFML/Graphics/RenderTextureImplDefault.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/Context.hpp>
 #include <SFML/System/Err.hpp>
 
 
@@ -147,6 +149,10 @@ bool RenderTexture::generateMipmap()
 ////////////////////////////////////////////////////////////
 bool RenderTexture::setActive(bool active)
 {
+    // Render the pending draws while the context is still active
+    if (!active)
+        flush();
+
     bool result = m_impl && m_impl->activate(active);
 
     // Update RenderTarget tracking
@@ -160,6 +166,9 @@ bool RenderTexture::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTexture::display()
 {
+    // Render the pending draws
+    flush();
+
     // Update the target texture
     if (m_impl && (priv::RenderTextureImplFBO::isAvailable() || setActive(true)))
     {
@@ -183,4 +192,22 @@ const Texture& RenderTexture::getTexture() const
     return m_texture;
 }
 
+
+////////////////////////////////////////////////////////////
+bool RenderTexture::exportDmaBuf(DmaBuf& buffer)
+{
+    if (!m_impl || !setActive(true))
+        return false;
+
+    // Make sure that the consumer of the buffer gets all the rendering commands
+    glCheck(glFlush());
+
+    if (!Context::exportTexture(m_texture.m_texture, buffer))
+        return false;
+
+    buffer.width = m_texture.getSize().x;
+    buffer.height = m_texture.getSize().y;
+    return true;
+}
+
 } // namespace sf
@@ -73,9 +73,20 @@ Vector2u RenderWindow::getSize() const
 }
 
 
+////////////////////////////////////////////////////////////
+Vector2u RenderWindow::getFramebufferSize() const
+{
+    return Window::getFramebufferSize();
+}
+
+
 ////////////////////////////////////////////////////////////
 bool RenderWindow::setActive(bool active)
 {
+    // Render the pending draws while the context is still active
+    if (!active)
+        flush();
+
     bool result = Window::setActive(active);
 
     // Update RenderTarget tracking
@@ -98,7 +109,7 @@ bool RenderWindow::setActive(bool active)
 ////////////////////////////////////////////////////////////
 Image RenderWindow::capture() const
 {
-    Vector2u windowSize = getSize();
+    Vector2u windowSize = getFramebufferSize();
 
     Texture texture;
     texture.create(windowSize.x, windowSize.y);
@@ -130,4 +141,12 @@ void RenderWindow::onResize()
     setView(getView());
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderWindow::onDisplay()
+{
+    // Render the pending draws before the backbuffer is shown
+    flush();
+}
+
 } // namespace sf
@@ -30,6 +30,7 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Transform.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/CoreRenderer.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/Window/Context.hpp>
 #include <SFML/System/InputStream.hpp>
@@ -942,6 +943,11 @@ bool Shader::compile(const char* vertexShaderCode, const char* geometryShaderCod
         glCheck(GLEXT_glDeleteObject(fragmentShader));
     }
 
+    // Bind the vertex attributes provided by sf::RenderTarget in core profile contexts
+    glCheck(GLEXT_glBindAttribLocation(shaderProgram, priv::CoreRenderer::PositionAttribute, "sf_position"));
+    glCheck(GLEXT_glBindAttribLocation(shaderProgram, priv::CoreRenderer::ColorAttribute, "sf_color"));
+    glCheck(GLEXT_glBindAttribLocation(shaderProgram, priv::CoreRenderer::TexCoordsAttribute, "sf_texCoords"));
+
     // Link the program
     glCheck(GLEXT_glLinkProgram(shaderProgram));
 
@@ -0,0 +1,521 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Batching.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/Context.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+
+
+#if !defined(GL_TRIANGLE_STRIP)
+    #define GL_TRIANGLE_STRIP 0x0005
+#endif
+
+
+namespace
+{
+    sf::Mutex isAvailableMutex;
+
+    typedef void (GLAD_API_PTR *glVertexAttribPointerFuncType)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    typedef void (GLAD_API_PTR *glEnableVertexAttribArrayFuncType)(GLuint);
+    typedef void (GLAD_API_PTR *glDisableVertexAttribArrayFuncType)(GLuint);
+    typedef GLint (GLAD_API_PTR *glGetAttribLocationFuncType)(GLuint, const GLchar*);
+    typedef void (GLAD_API_PTR *glVertexAttribDivisorFuncType)(GLuint, GLuint);
+    typedef void (GLAD_API_PTR *glDrawArraysInstancedFuncType)(GLenum, GLint, GLsizei, GLsizei);
+
+    // Instancing entry points, which glad doesn't load
+    glVertexAttribPointerFuncType      glVertexAttribPointerFunc      = NULL;
+    glEnableVertexAttribArrayFuncType  glEnableVertexAttribArrayFunc  = NULL;
+    glDisableVertexAttribArrayFuncType glDisableVertexAttribArrayFunc = NULL;
+    glGetAttribLocationFuncType        glGetAttribLocationFunc        = NULL;
+    glVertexAttribDivisorFuncType      glVertexAttribDivisorFunc      = NULL;
+    glDrawArraysInstancedFuncType      glDrawArraysInstancedFunc      = NULL;
+
+    // Names of the per-instance attributes, in the order of sf::SpriteBatch::m_attributes
+    const char* attributeNames[] = {"sf_instanceTransformX", "sf_instanceTransformY", "sf_instanceTextureRect", "sf_instanceColor"};
+
+    // Instancing shader for contexts with a fixed-function pipeline,
+    // the transform and texture matrices are applied by sf::RenderTarget
+    const char* vertexShaderSource =
+        "attribute vec3 sf_instanceTransformX;\n"
+        "attribute vec3 sf_instanceTransformY;\n"
+        "attribute vec4 sf_instanceTextureRect;\n"
+        "attribute vec4 sf_instanceColor;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 local = vec3(gl_Vertex.xy * abs(sf_instanceTextureRect.zw), 1.0);\n"
+        "    vec2 position = vec2(dot(sf_instanceTransformX, local), dot(sf_instanceTransformY, local));\n"
+        "    vec2 texCoords = sf_instanceTextureRect.xy + gl_MultiTexCoord0.xy * sf_instanceTextureRect.zw;\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 0.0, 1.0);\n"
+        "    gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(texCoords, 0.0, 1.0);\n"
+        "    gl_FrontColor = gl_Color * sf_instanceColor;\n"
+        "}\n";
+
+    const char* fragmentShaderSource =
+        "uniform sampler2D sf_texture;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = gl_Color * texture2D(sf_texture, gl_TexCoord[0].xy);\n"
+        "}\n";
+
+    // Instancing shader for core profile contexts, see sf::Shader for the built-in variables
+    const char* coreVertexShaderSource =
+        "#version 140\n"
+        "uniform mat4 sf_transform;\n"
+        "uniform mat4 sf_textureMatrix;\n"
+        "in vec2 sf_position;\n"
+        "in vec4 sf_color;\n"
+        "in vec2 sf_texCoords;\n"
+        "in vec3 sf_instanceTransformX;\n"
+        "in vec3 sf_instanceTransformY;\n"
+        "in vec4 sf_instanceTextureRect;\n"
+        "in vec4 sf_instanceColor;\n"
+        "out vec4 color;\n"
+        "out vec2 texCoords;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 local = vec3(sf_position * abs(sf_instanceTextureRect.zw), 1.0);\n"
+        "    vec2 position = vec2(dot(sf_instanceTransformX, local), dot(sf_instanceTransformY, local));\n"
+        "    gl_Position = sf_transform * vec4(position, 0.0, 1.0);\n"
+        "    texCoords = (sf_textureMatrix * vec4(sf_instanceTextureRect.xy + sf_texCoords * sf_instanceTextureRect.zw, 0.0, 1.0)).xy;\n"
+        "    color = sf_color * sf_instanceColor;\n"
+        "}\n";
+
+    const char* coreFragmentShaderSource =
+        "#version 140\n"
+        "uniform sampler2D sf_texture;\n"
+        "in vec4 color;\n"
+        "in vec2 texCoords;\n"
+        "out vec4 fragColor;\n"
+        "void main()\n"
+        "{\n"
+        "    fragColor = color * texture(sf_texture, texCoords);\n"
+        "}\n";
+
+    // Check whether the active context has at least the given version
+    bool isVersionAvailable(unsigned int major, unsigned int minor)
+    {
+        sf::ContextSettings settings = sf::Context::getActiveContextSettings();
+
+        return (settings.majorVersion > major) || ((settings.majorVersion == major) && (settings.minorVersion >= minor));
+    }
+
+    // Load a function which may only be available through its ARB variant
+    sf::GlFunctionPointer getFunction(const char* name, const char* arbName)
+    {
+        sf::GlFunctionPointer function = sf::Context::getFunction(name);
+
+        return function ? function : sf::Context::getFunction(arbName);
+    }
+
+    // Instancing shader shared by all the batches, for one kind of context
+    struct InstancingProgram
+    {
+        sf::Shader* shader;        // Compiled on first use, NULL until then
+        int         attributes[4]; // Locations of the per-instance attributes, -1 if missing
+    };
+
+    // Shaders are shared between contexts, so one program per kind of
+    // context is enough (fixed-function first, then core profile); they
+    // live as long as there are batches, and mutex to protect them
+    InstancingProgram instancingPrograms[2];
+    unsigned int batchCount = 0;
+    sf::Mutex programMutex;
+
+    // Count a new batch
+    void retainInstancingPrograms()
+    {
+        sf::Lock lock(programMutex);
+
+        batchCount++;
+    }
+
+    // Forget a batch, and destroy the programs along with the last one
+    void releaseInstancingPrograms()
+    {
+        sf::Lock lock(programMutex);
+
+        if (--batchCount > 0)
+            return;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            delete instancingPrograms[i].shader;
+            instancingPrograms[i].shader = NULL;
+        }
+    }
+
+    // Get the instancing program for a kind of context, compiling it on first use
+    const sf::Shader* getInstancingProgram(bool coreProfile, int* attributes)
+    {
+        sf::Lock lock(programMutex);
+
+        InstancingProgram& program = instancingPrograms[coreProfile ? 1 : 0];
+
+        if (!program.shader)
+        {
+            program.shader = new sf::Shader;
+            std::fill(program.attributes, program.attributes + 4, -1);
+
+            bool loaded = coreProfile ? program.shader->loadFromMemory(coreVertexShaderSource, coreFragmentShaderSource)
+                                      : program.shader->loadFromMemory(vertexShaderSource, fragmentShaderSource);
+
+            if (loaded)
+            {
+                program.shader->setUniform("sf_texture", sf::Shader::CurrentTexture);
+
+                GLuint handle = static_cast<GLuint>(program.shader->getNativeHandle());
+                for (int i = 0; i < 4; ++i)
+                    glCheck(program.attributes[i] = glGetAttribLocationFunc(handle, attributeNames[i]));
+            }
+            else
+            {
+                sf::err() << "Failed to compile the sprite batch shader, falling back to non-instanced rendering" << std::endl;
+            }
+        }
+
+        // Failures are remembered as well, so that we don't compile again on every draw
+        if (!program.shader->getNativeHandle() || (*std::min_element(program.attributes, program.attributes + 4) < 0))
+            return NULL;
+
+        std::copy(program.attributes, program.attributes + 4, attributes);
+        return program.shader;
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch() :
+m_texture            (NULL),
+m_instances          (),
+m_vertices           (),
+m_verticesNeedUpdate (false),
+m_instancesNeedUpload(false),
+m_instanceBuffer     (0),
+m_quad               (TriangleStrip, VertexBuffer::Static)
+{
+    std::fill(m_attributes, m_attributes + 4, -1);
+    retainInstancingPrograms();
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch(const Texture& texture) :
+m_texture            (&texture),
+m_instances          (),
+m_vertices           (),
+m_verticesNeedUpdate (false),
+m_instancesNeedUpload(false),
+m_instanceBuffer     (0),
+m_quad               (TriangleStrip, VertexBuffer::Static)
+{
+    std::fill(m_attributes, m_attributes + 4, -1);
+    retainInstancingPrograms();
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch(const SpriteBatch& copy) :
+Drawable             (),
+GlResource           (),
+m_texture            (copy.m_texture),
+m_instances          (copy.m_instances),
+m_vertices           (),
+m_verticesNeedUpdate (true),
+m_instancesNeedUpload(true),
+m_instanceBuffer     (0),
+m_quad               (TriangleStrip, VertexBuffer::Static)
+{
+    // The OpenGL objects are created again on the first draw of the copy,
+    // except for the instancing shader which all the batches share
+    std::fill(m_attributes, m_attributes + 4, -1);
+    retainInstancingPrograms();
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch::~SpriteBatch()
+{
+    if (m_instanceBuffer)
+    {
+        TransientContextLock contextLock;
+
+        glCheck(GLEXT_glDeleteBuffers(1, &m_instanceBuffer));
+    }
+
+    releaseInstancingPrograms();
+}
+
+
+////////////////////////////////////////////////////////////
+SpriteBatch& SpriteBatch::operator =(const SpriteBatch& right)
+{
+    SpriteBatch temp(right);
+
+    swap(temp);
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::swap(SpriteBatch& right)
+{
+    std::swap(m_texture,             right.m_texture);
+    std::swap(m_instances,           right.m_instances);
+    std::swap(m_vertices,            right.m_vertices);
+    std::swap(m_verticesNeedUpdate,  right.m_verticesNeedUpdate);
+    std::swap(m_instancesNeedUpload, right.m_instancesNeedUpload);
+    std::swap(m_instanceBuffer,      right.m_instanceBuffer);
+    std::swap_ranges(m_attributes, m_attributes + 4, right.m_attributes);
+    m_quad.swap(right.m_quad);
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::setTexture(const Texture& texture)
+{
+    m_texture = &texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* SpriteBatch::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Sprite& sprite)
+{
+    add(sprite.getTransform(), sprite.getTextureRect(), sprite.getColor());
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Transform& transform, const IntRect& textureRect, const Color& color)
+{
+    const float* matrix = transform.getMatrix();
+
+    Instance instance;
+    instance.transform[0] = matrix[0];
+    instance.transform[1] = matrix[4];
+    instance.transform[2] = matrix[12];
+    instance.transform[3] = matrix[1];
+    instance.transform[4] = matrix[5];
+    instance.transform[5] = matrix[13];
+    instance.textureRect[0] = static_cast<float>(textureRect.left);
+    instance.textureRect[1] = static_cast<float>(textureRect.top);
+    instance.textureRect[2] = static_cast<float>(textureRect.width);
+    instance.textureRect[3] = static_cast<float>(textureRect.height);
+    instance.color = color;
+
+    m_instances.push_back(instance);
+
+    m_verticesNeedUpdate = true;
+    m_instancesNeedUpload = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::clear()
+{
+    m_instances.clear();
+
+    m_verticesNeedUpdate = true;
+    m_instancesNeedUpload = true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::getSpriteCount() const
+{
+    return m_instances.size();
+}
+
+
+////////////////////////////////////////////////////////////
+bool SpriteBatch::isInstancingAvailable()
+{
+    // Check these first, they acquire their own context
+    if (!Shader::isAvailable() || !VertexBuffer::isAvailable())
+        return false;
+
+    Lock lock(isAvailableMutex);
+
+    static bool checked = false;
+    static bool available = false;
+
+    if (!checked)
+    {
+        checked = true;
+
+        TransientContextLock contextLock;
+
+        bool instancing = isVersionAvailable(3, 3) ||
+                          (Context::isExtensionAvailable("GL_ARB_instanced_arrays") &&
+                           Context::isExtensionAvailable("GL_ARB_draw_instanced"));
+
+        if (instancing)
+        {
+            glVertexAttribPointerFunc      = reinterpret_cast<glVertexAttribPointerFuncType>(getFunction("glVertexAttribPointer", "glVertexAttribPointerARB"));
+            glEnableVertexAttribArrayFunc  = reinterpret_cast<glEnableVertexAttribArrayFuncType>(getFunction("glEnableVertexAttribArray", "glEnableVertexAttribArrayARB"));
+            glDisableVertexAttribArrayFunc = reinterpret_cast<glDisableVertexAttribArrayFuncType>(getFunction("glDisableVertexAttribArray", "glDisableVertexAttribArrayARB"));
+            glGetAttribLocationFunc        = reinterpret_cast<glGetAttribLocationFuncType>(getFunction("glGetAttribLocation", "glGetAttribLocationARB"));
+            glVertexAttribDivisorFunc      = reinterpret_cast<glVertexAttribDivisorFuncType>(getFunction("glVertexAttribDivisor", "glVertexAttribDivisorARB"));
+            glDrawArraysInstancedFunc      = reinterpret_cast<glDrawArraysInstancedFuncType>(getFunction("glDrawArraysInstanced", "glDrawArraysInstancedARB"));
+        }
+
+        available = instancing &&
+                    glVertexAttribPointerFunc && glEnableVertexAttribArrayFunc && glDisableVertexAttribArrayFunc &&
+                    glGetAttribLocationFunc && glVertexAttribDivisorFunc && glDrawArraysInstancedFunc;
+    }
+
+    return available;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    target.draw(*this, states);
+}
+
+
+////////////////////////////////////////////////////////////
+const Shader* SpriteBatch::prepareInstancing(bool coreProfile) const
+{
+    // Get the shader matching the kind of context
+    const Shader* shader = getInstancingProgram(coreProfile, m_attributes);
+
+    if (!shader)
+        return NULL;
+
+    // Create the unit quad that is instanced for each sprite
+    if (!m_quad.getNativeHandle())
+    {
+        Vertex quad[] =
+        {
+            Vertex(Vector2f(0.f, 0.f), Vector2f(0.f, 0.f)),
+            Vertex(Vector2f(0.f, 1.f), Vector2f(0.f, 1.f)),
+            Vertex(Vector2f(1.f, 0.f), Vector2f(1.f, 0.f)),
+            Vertex(Vector2f(1.f, 1.f), Vector2f(1.f, 1.f))
+        };
+
+        if (!m_quad.create(4) || !m_quad.update(quad))
+            return NULL;
+    }
+
+    // Upload the instances if they changed since the last draw
+    if (!m_instanceBuffer)
+    {
+        glCheck(GLEXT_glGenBuffers(1, &m_instanceBuffer));
+        m_instancesNeedUpload = true;
+    }
+
+    if (!m_instanceBuffer)
+        return NULL;
+
+    if (m_instancesNeedUpload)
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_instanceBuffer));
+        glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, sizeof(Instance) * m_instances.size(), &m_instances[0], GLEXT_GL_STREAM_DRAW));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        m_instancesNeedUpload = false;
+    }
+
+    return shader;
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::drawInstances() const
+{
+    static const GLint sizes[] = {3, 3, 4, 4};
+    static const GLenum types[] = {GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_UNSIGNED_BYTE};
+    static const std::size_t offsets[] = {0, 12, 24, 40};
+
+    // Advance the per-instance attributes once per sprite rather than once per vertex
+    glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_instanceBuffer));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        GLuint location = static_cast<GLuint>(m_attributes[i]);
+        GLboolean normalized = (types[i] == GL_UNSIGNED_BYTE) ? GL_TRUE : GL_FALSE;
+
+        glCheck(glEnableVertexAttribArrayFunc(location));
+        glCheck(glVertexAttribPointerFunc(location, sizes[i], types[i], normalized, sizeof(Instance), reinterpret_cast<const void*>(offsets[i])));
+        glCheck(glVertexAttribDivisorFunc(location, 1));
+    }
+
+    glCheck(glDrawArraysInstancedFunc(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_instances.size())));
+
+    // Restore the attributes, so that they don't affect the next draws
+    for (int i = 0; i < 4; ++i)
+    {
+        GLuint location = static_cast<GLuint>(m_attributes[i]);
+
+        glCheck(glVertexAttribDivisorFunc(location, 0));
+        glCheck(glDisableVertexAttribArrayFunc(location));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Vertex>& SpriteBatch::getVertices() const
+{
+    if (!m_verticesNeedUpdate)
+        return m_vertices;
+
+    m_vertices.resize(m_instances.size() * 6);
+
+    for (std::size_t i = 0; i < m_instances.size(); ++i)
+    {
+        const Instance& instance = m_instances[i];
+        priv::getSpriteVertices(instance.transform, instance.textureRect, instance.color, &m_vertices[i * 6]);
+    }
+
+    m_verticesNeedUpdate = false;
+
+    return m_vertices;
+}
+
+} // namespace sf
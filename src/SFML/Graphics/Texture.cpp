@@ -306,6 +306,46 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::loadFromDmaBuf(const DmaBuf& buffer)
+{
+    return loadFromExternal(&buffer, NULL, buffer.width, buffer.height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromEglImage(void* image, unsigned int width, unsigned int height)
+{
+    return loadFromExternal(NULL, image, width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::waitFence(int fence)
+{
+    // Fences only order the commands of the context they are queued in:
+    // activating the shared context here would make the wait useless.
+    // Without an active context, the fence is released and the call fails
+    if (!Context::getActiveContextId())
+        err() << "Failed to wait for a fence, no context is active" << std::endl;
+
+    return Context::waitFence(fence);
+}
+
+
+////////////////////////////////////////////////////////////
+int Texture::createFence() const
+{
+    if (!Context::getActiveContextId())
+    {
+        err() << "Failed to create a fence, no context is active" << std::endl;
+        return -1;
+    }
+
+    return Context::createFence();
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2u Texture::getSize() const
 {
@@ -565,8 +605,8 @@ void Texture::update(const Window& window)
 ////////////////////////////////////////////////////////////
 void Texture::update(const Window& window, unsigned int x, unsigned int y)
 {
-    assert(x + window.getSize().x <= m_size.x);
-    assert(y + window.getSize().y <= m_size.y);
+    assert(x + window.getFramebufferSize().x <= m_size.x);
+    assert(y + window.getFramebufferSize().y <= m_size.y);
 
     if (m_texture && window.setActive(true))
     {
@@ -577,7 +617,7 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
 
         // Copy pixels from the back-buffer to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
-        glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
+        glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getFramebufferSize().x, window.getFramebufferSize().y));
         glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
         m_hasMipmap = false;
         m_pixelsFlipped = true;
@@ -713,6 +753,63 @@ bool Texture::generateMipmap()
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::loadFromExternal(const DmaBuf* buffer, void* image, unsigned int width, unsigned int height)
+{
+    // Check if texture parameters are valid before importing it
+    if ((width == 0) || (height == 0))
+    {
+        err() << "Failed to import texture, invalid size (" << width << "x" << height << ")" << std::endl;
+        return false;
+    }
+
+    TransientContextLock lock;
+
+    // Make sure that extensions are initialized
+    priv::ensureExtensionsInit();
+
+    // The size of external images can't be rounded up
+    if ((getValidSize(width) != width) || (getValidSize(height) != height))
+    {
+        err() << "Failed to import texture, non power-of-two textures are not supported" << std::endl;
+        return false;
+    }
+
+    // Create the OpenGL texture if it doesn't exist yet
+    if (!m_texture)
+    {
+        GLuint texture;
+        glCheck(glGenTextures(1, &texture));
+        m_texture = static_cast<unsigned int>(texture);
+    }
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    if (!(buffer ? Context::importTexture(*buffer) : Context::importTexture(image)))
+        return false;
+
+    static bool textureEdgeClamp = GLEXT_texture_edge_clamp;
+
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : (textureEdgeClamp ? GLEXT_GL_CLAMP_TO_EDGE : GLEXT_GL_CLAMP)));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : (textureEdgeClamp ? GLEXT_GL_CLAMP_TO_EDGE : GLEXT_GL_CLAMP)));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+
+    // The import succeeded, we can store the new texture settings
+    m_size.x        = width;
+    m_size.y        = height;
+    m_actualSize    = m_size;
+    m_pixelsFlipped = false;
+    m_fboAttachment = false;
+    m_hasMipmap     = false;
+    m_cacheId       = getUniqueId();
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::invalidateMipmap()
 {
@@ -731,38 +828,51 @@ void Texture::invalidateMipmap()
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::getTextureMatrix(CoordinateType coordinateType, float matrix[16]) const
+{
+    static const float identity[16] = {1.f, 0.f, 0.f, 0.f,
+                                       0.f, 1.f, 0.f, 0.f,
+                                       0.f, 0.f, 1.f, 0.f,
+                                       0.f, 0.f, 0.f, 1.f};
+
+    std::memcpy(matrix, identity, sizeof(identity));
+
+    // If non-normalized coordinates (= pixels) are requested, we need to
+    // setup scale factors that convert the range [0 .. size] to [0 .. 1]
+    if (coordinateType == Pixels)
+    {
+        matrix[0] = 1.f / m_actualSize.x;
+        matrix[5] = 1.f / m_actualSize.y;
+    }
+
+    // If pixels are flipped we must invert the Y axis
+    if (m_pixelsFlipped)
+    {
+        matrix[5] = -matrix[5];
+        matrix[13] = static_cast<float>(m_size.y) / m_actualSize.y;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
     TransientContextLock lock;
 
+    // Core profile contexts have no texture matrix, shaders must apply it themselves
+    bool core = (Context::getActiveContextSettings().attributeFlags & ContextSettings::Core) != 0;
+
     if (texture && texture->m_texture)
     {
         // Bind the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, texture->m_texture));
 
         // Check if we need to define a special texture matrix
-        if ((coordinateType == Pixels) || texture->m_pixelsFlipped)
+        if (!core && ((coordinateType == Pixels) || texture->m_pixelsFlipped))
         {
-            GLfloat matrix[16] = {1.f, 0.f, 0.f, 0.f,
-                                  0.f, 1.f, 0.f, 0.f,
-                                  0.f, 0.f, 1.f, 0.f,
-                                  0.f, 0.f, 0.f, 1.f};
-
-            // If non-normalized coordinates (= pixels) are requested, we need to
-            // setup scale factors that convert the range [0 .. size] to [0 .. 1]
-            if (coordinateType == Pixels)
-            {
-                matrix[0] = 1.f / texture->m_actualSize.x;
-                matrix[5] = 1.f / texture->m_actualSize.y;
-            }
-
-            // If pixels are flipped we must invert the Y axis
-            if (texture->m_pixelsFlipped)
-            {
-                matrix[5] = -matrix[5];
-                matrix[13] = static_cast<float>(texture->m_size.y) / texture->m_actualSize.y;
-            }
+            GLfloat matrix[16];
+            texture->getTextureMatrix(coordinateType, matrix);
 
             // Load the matrix
             glCheck(glMatrixMode(GL_TEXTURE));
@@ -777,12 +887,15 @@ void Texture::bind(const Texture* texture, CoordinateType coordinateType)
         // Bind no texture
         glCheck(glBindTexture(GL_TEXTURE_2D, 0));
 
-        // Reset the texture matrix
-        glCheck(glMatrixMode(GL_TEXTURE));
-        glCheck(glLoadIdentity());
+        if (!core)
+        {
+            // Reset the texture matrix
+            glCheck(glMatrixMode(GL_TEXTURE));
+            glCheck(glLoadIdentity());
 
-        // Go back to model-view mode (sf::RenderTarget relies on it)
-        glCheck(glMatrixMode(GL_MODELVIEW));
+            // Go back to model-view mode (sf::RenderTarget relies on it)
+            glCheck(glMatrixMode(GL_MODELVIEW));
+        }
     }
 }
 
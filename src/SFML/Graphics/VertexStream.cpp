@@ -0,0 +1,482 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/VertexStream.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Window/Context.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+
+#if !defined(GL_ARRAY_BUFFER)
+    #define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#if !defined(GL_STREAM_DRAW)
+    #define GL_STREAM_DRAW 0x88E0
+#endif
+
+#if !defined(GL_MAP_WRITE_BIT)
+    #define GL_MAP_WRITE_BIT 0x0002
+#endif
+
+#if !defined(GL_MAP_PERSISTENT_BIT)
+    #define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+
+#if !defined(GL_MAP_COHERENT_BIT)
+    #define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+#if !defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+
+#if !defined(GL_SYNC_FLUSH_COMMANDS_BIT)
+    #define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+
+#if !defined(GL_TIMEOUT_EXPIRED)
+    #define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+
+#if !defined(GL_WAIT_FAILED)
+    #define GL_WAIT_FAILED 0x911D
+#endif
+
+
+namespace
+{
+    // Number of sections the buffer is split into, each one guarded by its own fence
+    const std::size_t SectionCount = 4;
+
+    // Initial capacity of the buffer, in vertices
+    const std::size_t MinimumCapacity = 16384;
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+struct VertexStream::ContextStream
+{
+    GLuint      buffer;                  //!< Buffer object into which the vertices are streamed
+    Uint64      cacheId;                 //!< Unique identifier of the buffer, for the states caches
+    std::size_t capacity;                //!< Size of the buffer, in vertices
+    std::size_t offset;                  //!< Index of the next vertex to write
+    bool        persistent;              //!< Is the buffer mapped persistently?
+    char*       mapping;                 //!< Persistent mapping of the buffer
+    std::size_t section;                 //!< Section currently being written
+    GLsync      fences[SectionCount];    //!< Fences placed after the last draw reading each section
+    bool        unfenced[SectionCount];  //!< Sections written since the last fences were placed
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+namespace
+{
+    typedef void (GLAD_API_PTR *glGenBuffersFuncType)(GLsizei, GLuint*);
+    typedef void (GLAD_API_PTR *glBindBufferFuncType)(GLenum, GLuint);
+    typedef void (GLAD_API_PTR *glBufferDataFuncType)(GLenum, GLsizeiptr, const void*, GLenum);
+    typedef void (GLAD_API_PTR *glBufferSubDataFuncType)(GLenum, GLintptr, GLsizeiptr, const void*);
+    typedef void (GLAD_API_PTR *glDeleteBuffersFuncType)(GLsizei, const GLuint*);
+    typedef void (GLAD_API_PTR *glBufferStorageFuncType)(GLenum, GLsizeiptr, const void*, GLbitfield);
+    typedef void* (GLAD_API_PTR *glMapBufferRangeFuncType)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    typedef GLboolean (GLAD_API_PTR *glUnmapBufferFuncType)(GLenum);
+    typedef GLsync (GLAD_API_PTR *glFenceSyncFuncType)(GLenum, GLbitfield);
+    typedef GLenum (GLAD_API_PTR *glClientWaitSyncFuncType)(GLsync, GLbitfield, GLuint64);
+    typedef void (GLAD_API_PTR *glDeleteSyncFuncType)(GLsync);
+
+    // Buffer entry points, loaded by name since core profile
+    // contexts don't advertise ARB_vertex_buffer_object
+    glGenBuffersFuncType     glGenBuffersFunc     = NULL;
+    glBindBufferFuncType     glBindBufferFunc     = NULL;
+    glBufferDataFuncType     glBufferDataFunc     = NULL;
+    glBufferSubDataFuncType  glBufferSubDataFunc  = NULL;
+    glDeleteBuffersFuncType  glDeleteBuffersFunc  = NULL;
+    glBufferStorageFuncType  glBufferStorageFunc  = NULL; // Optional, core since 4.4
+    glMapBufferRangeFuncType glMapBufferRangeFunc = NULL; // Optional, core since 3.0
+    glUnmapBufferFuncType    glUnmapBufferFunc    = NULL; // Optional, core since 1.5
+    glFenceSyncFuncType      glFenceSyncFunc      = NULL; // Optional, core since 3.2
+    glClientWaitSyncFuncType glClientWaitSyncFunc = NULL; // Optional, core since 3.2
+    glDeleteSyncFuncType     glDeleteSyncFunc     = NULL; // Optional, core since 3.2
+
+    // Streams of each context, and mutex to protect them
+    typedef std::map<sf::Uint64, sf::priv::VertexStream::ContextStream> ContextStreamMap;
+    ContextStreamMap contextStreams;
+    sf::Mutex mutex;
+
+    // Thread-safe unique identifier generator for the buffers,
+    // as their OpenGL handles are reused once they are deleted
+    sf::Uint64 getUniqueId()
+    {
+        sf::Lock lock(mutex);
+
+        static sf::Uint64 id = 1; // start at 1, zero is "no buffer"
+
+        return id++;
+    }
+
+    // Check whether the active context has at least the given version
+    bool isVersionAvailable(unsigned int major, unsigned int minor)
+    {
+        sf::ContextSettings settings = sf::Context::getActiveContextSettings();
+
+        return (settings.majorVersion > major) || ((settings.majorVersion == major) && (settings.minorVersion >= minor));
+    }
+
+    // Load the buffer entry points, return false if streaming is unavailable
+    bool loadFunctions()
+    {
+        static bool loaded = false;
+        static bool complete = false;
+
+        if (!loaded)
+        {
+            loaded = true;
+
+            // Buffer objects without the ARB suffix only exist since OpenGL 1.5
+            if (!isVersionAvailable(1, 5))
+                return false;
+
+            glGenBuffersFunc     = reinterpret_cast<glGenBuffersFuncType>(sf::Context::getFunction("glGenBuffers"));
+            glBindBufferFunc     = reinterpret_cast<glBindBufferFuncType>(sf::Context::getFunction("glBindBuffer"));
+            glBufferDataFunc     = reinterpret_cast<glBufferDataFuncType>(sf::Context::getFunction("glBufferData"));
+            glBufferSubDataFunc  = reinterpret_cast<glBufferSubDataFuncType>(sf::Context::getFunction("glBufferSubData"));
+            glDeleteBuffersFunc  = reinterpret_cast<glDeleteBuffersFuncType>(sf::Context::getFunction("glDeleteBuffers"));
+            glBufferStorageFunc  = reinterpret_cast<glBufferStorageFuncType>(sf::Context::getFunction("glBufferStorage"));
+            glMapBufferRangeFunc = reinterpret_cast<glMapBufferRangeFuncType>(sf::Context::getFunction("glMapBufferRange"));
+            glUnmapBufferFunc    = reinterpret_cast<glUnmapBufferFuncType>(sf::Context::getFunction("glUnmapBuffer"));
+            glFenceSyncFunc      = reinterpret_cast<glFenceSyncFuncType>(sf::Context::getFunction("glFenceSync"));
+            glClientWaitSyncFunc = reinterpret_cast<glClientWaitSyncFuncType>(sf::Context::getFunction("glClientWaitSync"));
+            glDeleteSyncFunc     = reinterpret_cast<glDeleteSyncFuncType>(sf::Context::getFunction("glDeleteSync"));
+
+            complete = glGenBuffersFunc && glBindBufferFunc && glBufferDataFunc &&
+                       glBufferSubDataFunc && glDeleteBuffersFunc;
+        }
+
+        return complete;
+    }
+
+    // Check whether the active context can map a buffer persistently
+    bool isPersistentMappingAvailable()
+    {
+        // Some platforms return non-NULL pointers for functions which
+        // the context doesn't support, so check the version as well
+        bool storage = isVersionAvailable(4, 4) || sf::Context::isExtensionAvailable("GL_ARB_buffer_storage");
+        bool mapRange = isVersionAvailable(3, 0) || sf::Context::isExtensionAvailable("GL_ARB_map_buffer_range");
+        bool sync = isVersionAvailable(3, 2) || sf::Context::isExtensionAvailable("GL_ARB_sync");
+
+        return storage && mapRange && sync &&
+               glBufferStorageFunc && glMapBufferRangeFunc && glUnmapBufferFunc &&
+               glFenceSyncFunc && glClientWaitSyncFunc && glDeleteSyncFunc;
+    }
+
+    // Wait until the GPU has executed the commands preceding a fence, and delete it
+    void waitFence(GLsync& fence)
+    {
+        if (!fence)
+            return;
+
+        // Flush on the first wait only, so that the fence is guaranteed to be signaled eventually
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        GLenum result;
+
+        do
+        {
+            glCheck(result = glClientWaitSyncFunc(fence, flags, 1000000000));
+            flags = 0;
+        }
+        while (result == GL_TIMEOUT_EXPIRED);
+
+        if (result == GL_WAIT_FAILED)
+            sf::err() << "Failed to wait for the GPU to release streamed vertices" << std::endl;
+
+        glCheck(glDeleteSyncFunc(fence));
+        fence = NULL;
+    }
+
+    // Delete the buffer of a stream, along with its fences
+    void destroyBuffer(sf::priv::VertexStream::ContextStream& stream)
+    {
+        for (std::size_t i = 0; i < SectionCount; ++i)
+        {
+            if (stream.fences[i])
+                glCheck(glDeleteSyncFunc(stream.fences[i]));
+
+            stream.fences[i] = NULL;
+            stream.unfenced[i] = false;
+        }
+
+        if (stream.buffer)
+        {
+            // Deleting a buffer implicitly unmaps it
+            glCheck(glDeleteBuffersFunc(1, &stream.buffer));
+        }
+
+        stream.buffer = 0;
+        stream.cacheId = 0;
+        stream.capacity = 0;
+        stream.offset = 0;
+        stream.mapping = NULL;
+        stream.section = 0;
+    }
+
+    // Create the buffer of a stream, leave it bound to GL_ARRAY_BUFFER
+    bool createBuffer(sf::priv::VertexStream::ContextStream& stream, std::size_t capacity)
+    {
+        GLsizeiptr size = static_cast<GLsizeiptr>(sizeof(sf::Vertex) * capacity);
+
+        glCheck(glGenBuffersFunc(1, &stream.buffer));
+
+        if (!stream.buffer)
+        {
+            sf::err() << "Failed to create the vertex stream buffer" << std::endl;
+            return false;
+        }
+
+        glCheck(glBindBufferFunc(GL_ARRAY_BUFFER, stream.buffer));
+
+        stream.cacheId = getUniqueId();
+        stream.capacity = capacity;
+        stream.offset = 0;
+        stream.section = 0;
+
+        if (stream.persistent)
+        {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+            glCheck(glBufferStorageFunc(GL_ARRAY_BUFFER, size, NULL, flags));
+            glCheck(stream.mapping = static_cast<char*>(glMapBufferRangeFunc(GL_ARRAY_BUFFER, 0, size, flags)));
+
+            if (stream.mapping)
+                return true;
+
+            // Storage is immutable, so fall back to orphaning with a new buffer
+            sf::err() << "Failed to map the vertex stream buffer persistently, falling back to uploads" << std::endl;
+
+            glCheck(glDeleteBuffersFunc(1, &stream.buffer));
+            glCheck(glGenBuffersFunc(1, &stream.buffer));
+            glCheck(glBindBufferFunc(GL_ARRAY_BUFFER, stream.buffer));
+
+            stream.cacheId = getUniqueId();
+            stream.persistent = false;
+        }
+
+        glCheck(glBufferDataFunc(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW));
+
+        return true;
+    }
+
+    // Callback that is called every time a context is destroyed
+    void contextDestroyCallback(void* /*arg*/)
+    {
+        sf::Lock lock(mutex);
+
+        ContextStreamMap::iterator iter = contextStreams.find(sf::Context::getActiveContextId());
+
+        if (iter == contextStreams.end())
+            return;
+
+        destroyBuffer(iter->second);
+
+        contextStreams.erase(iter);
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+VertexStream::VertexStream() :
+m_contextId(0),
+m_stream   (NULL)
+{
+    Lock lock(mutex);
+
+    // Register the context destruction callback
+    registerContextDestroyCallback(contextDestroyCallback, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+bool VertexStream::write(const Vertex* vertices, std::size_t vertexCount, std::size_t& firstVertex)
+{
+    ContextStream* stream = getStream();
+
+    if (!stream || !vertexCount)
+        return false;
+
+    // Grow the buffer if the vertices can't fit in it; the previous
+    // one is only released by the driver once it's no longer used
+    if (vertexCount > stream->capacity)
+    {
+        std::size_t capacity = std::max(vertexCount, stream->capacity * 2);
+        capacity = (capacity + SectionCount * 4 - 1) / (SectionCount * 4) * (SectionCount * 4);
+
+        destroyBuffer(*stream);
+
+        if (!createBuffer(*stream, capacity))
+            return false;
+    }
+    else
+    {
+        glCheck(glBindBufferFunc(GL_ARRAY_BUFFER, stream->buffer));
+    }
+
+    // Start on a quad boundary, and wrap around if the end of the buffer is reached
+    std::size_t offset = (stream->offset + 3) / 4 * 4;
+    bool wrapped = (offset + vertexCount > stream->capacity);
+
+    if (wrapped)
+        offset = 0;
+
+    if (stream->persistent)
+    {
+        std::size_t sectionSize = stream->capacity / SectionCount;
+        std::size_t first = offset / sectionSize;
+        std::size_t last = (offset + vertexCount - 1) / sectionSize;
+
+        // Entering other sections: all the draws that read the sections written so
+        // far have been issued, so fence them before waiting for the ones entered
+        if (wrapped || (last != stream->section))
+        {
+            for (std::size_t i = 0; i < SectionCount; ++i)
+            {
+                if (stream->unfenced[i])
+                {
+                    if (stream->fences[i])
+                        glCheck(glDeleteSyncFunc(stream->fences[i]));
+
+                    glCheck(stream->fences[i] = glFenceSyncFunc(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+                    stream->unfenced[i] = false;
+                }
+            }
+
+            // The current section only holds vertices before the offset, unless we wrapped around
+            for (std::size_t i = first; i <= last; ++i)
+            {
+                if (wrapped || (i != stream->section))
+                    waitFence(stream->fences[i]);
+            }
+        }
+
+        for (std::size_t i = first; i <= last; ++i)
+            stream->unfenced[i] = true;
+
+        stream->section = last;
+
+        std::memcpy(stream->mapping + sizeof(Vertex) * offset, vertices, sizeof(Vertex) * vertexCount);
+    }
+    else
+    {
+        // Orphan the storage rather than waiting until the GPU is done with it
+        if (wrapped)
+            glCheck(glBufferDataFunc(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * stream->capacity), NULL, GL_STREAM_DRAW));
+
+        glCheck(glBufferSubDataFunc(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(Vertex) * offset),
+                                    static_cast<GLsizeiptr>(sizeof(Vertex) * vertexCount), vertices));
+    }
+
+    stream->offset = offset + vertexCount;
+    firstVertex = offset;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 VertexStream::getCacheId()
+{
+    ContextStream* stream = getStream();
+
+    return stream ? stream->cacheId : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+VertexStream::ContextStream* VertexStream::getStream()
+{
+    Uint64 contextId = Context::getActiveContextId();
+
+    // The stream of a context is destroyed along with it, and
+    // context IDs are never reused, so the cache stays valid
+    if (m_stream && (contextId == m_contextId))
+        return m_stream;
+
+    Lock lock(mutex);
+
+    m_contextId = contextId;
+    m_stream = NULL;
+
+    if (!contextId || !loadFunctions())
+        return NULL;
+
+    ContextStreamMap::iterator iter = contextStreams.find(contextId);
+
+    if (iter != contextStreams.end())
+    {
+        m_stream = &iter->second;
+        return m_stream;
+    }
+
+    // First use of this context: create its stream
+    ContextStream stream;
+    stream.buffer = 0;
+    stream.cacheId = 0;
+    stream.persistent = isPersistentMappingAvailable();
+    stream.mapping = NULL;
+
+    for (std::size_t i = 0; i < SectionCount; ++i)
+    {
+        stream.fences[i] = NULL;
+        stream.unfenced[i] = false;
+    }
+
+    if (!createBuffer(stream, MinimumCapacity))
+        return NULL;
+
+    m_stream = &contextStreams.insert(std::make_pair(contextId, stream)).first->second;
+    return m_stream;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_VERTEXSTREAM_HPP
+#define SFML_VERTEXSTREAM_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/GlResource.hpp>
+#include <SFML/Config.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+class Vertex;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Ring buffer into which client-side vertices are
+///        streamed before being drawn
+///
+/// Drawing from client memory forces the driver to copy the
+/// vertices synchronously on every draw call. Instead, the
+/// vertices are appended to a buffer object and drawn from
+/// there, at an offset.
+///
+/// Where OpenGL 4.4 or ARB_buffer_storage is available, the
+/// buffer is mapped persistently and filled with a plain copy;
+/// it is split into sections, and a fence placed after the last
+/// draw reading a section is waited for before overwriting it.
+/// Otherwise, the vertices are uploaded with glBufferSubData,
+/// and the buffer is orphaned once it is full.
+///
+/// Mappings and fences are tied to a context, so each context
+/// has its own buffer, destroyed along with it.
+///
+////////////////////////////////////////////////////////////
+class VertexStream : GlResource
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief State of the stream in a context
+    ///
+    ////////////////////////////////////////////////////////////
+    struct ContextStream;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    VertexStream();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Append vertices to the stream of the active context
+    ///
+    /// On success, the buffer of the stream is left bound to
+    /// GL_ARRAY_BUFFER. The first vertex is always aligned on
+    /// a quad boundary, so that quads can be indexed from it.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param firstVertex Receives the index of the first vertex in the buffer
+    ///
+    /// \return True if the vertices were written, false if streaming is unavailable
+    ///
+    ////////////////////////////////////////////////////////////
+    bool write(const Vertex* vertices, std::size_t vertexCount, std::size_t& firstVertex);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the identifier of the buffer of the active context
+    ///
+    /// The buffer is recreated whenever it has to grow, so vertex
+    /// pointers targeting it must be compared against this
+    /// identifier after each write. Unlike the OpenGL handle,
+    /// which the driver may give to the new buffer again, the
+    /// identifier is never reused.
+    ///
+    /// \return Identifier of the buffer, or 0 if there's none
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 getCacheId();
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the stream of the active context
+    ///
+    /// \return Stream of the active context, or NULL if it couldn't be created
+    ///
+    ////////////////////////////////////////////////////////////
+    ContextStream* getStream();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Uint64         m_contextId; //!< Context of the cached stream
+    ContextStream* m_stream;    //!< Stream of the last context used, if still alive
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_VERTEXSTREAM_HPP
@@ -41,6 +41,13 @@ String ClipboardImpl::getString()
 }
 
 
+////////////////////////////////////////////////////////////
+void ClipboardImpl::requestString(Clipboard::StringCallback callback, void* userData)
+{
+    callback(getString(), userData);
+}
+
+
 ////////////////////////////////////////////////////////////
 void ClipboardImpl::setString(const String& text)
 {
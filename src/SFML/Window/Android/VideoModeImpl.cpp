@@ -58,6 +58,14 @@ VideoMode VideoModeImpl::getDesktopMode()
     return VideoMode(states->screenSize.x, states->screenSize.y);
 }
 
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImpl::getMonitors()
+{
+    // Monitors are not enumerated yet, Monitor::getMonitors describes the desktop instead
+    return std::vector<Monitor>();
+}
+
 } // namespace priv
 
 } // namespace sf
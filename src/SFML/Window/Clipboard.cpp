@@ -39,6 +39,13 @@ String Clipboard::getString()
 }
 
 
+////////////////////////////////////////////////////////////
+void Clipboard::requestString(StringCallback callback, void* userData)
+{
+    priv::ClipboardImpl::requestString(callback, userData);
+}
+
+
 ////////////////////////////////////////////////////////////
 void Clipboard::setString(const String& text)
 {
@@ -87,6 +87,13 @@ Uint64 Context::getActiveContextId()
 }
 
 
+////////////////////////////////////////////////////////////
+ContextSettings Context::getActiveContextSettings()
+{
+    return priv::GlContext::getActiveContextSettings();
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Context::isExtensionAvailable(const char* name)
 {
@@ -101,6 +108,41 @@ GlFunctionPointer Context::getFunction(const char* name)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Context::exportTexture(unsigned int texture, DmaBuf& buffer)
+{
+    return priv::GlContext::exportTexture(texture, buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Context::importTexture(const DmaBuf& buffer)
+{
+    return priv::GlContext::importTexture(buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool Context::importTexture(void* image)
+{
+    return priv::GlContext::importTexture(image);
+}
+
+
+////////////////////////////////////////////////////////////
+int Context::createFence()
+{
+    return priv::GlContext::createFence();
+}
+
+
+////////////////////////////////////////////////////////////
+bool Context::waitFence(int fence)
+{
+    return priv::GlContext::waitFence(fence);
+}
+
+
 ////////////////////////////////////////////////////////////
 Context::Context(const ContextSettings& settings, unsigned int width, unsigned int height)
 {
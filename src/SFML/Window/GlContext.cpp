@@ -59,6 +59,8 @@
 
 #elif defined(SFML_SYSTEM_LINUX) || defined(SFML_SYSTEM_FREEBSD) || defined(SFML_SYSTEM_OPENBSD)
 
+    #include <unistd.h>
+
     #if defined(SFML_OPENGL_ES)
 
         typedef sf::priv::EglContext ContextType;
@@ -302,6 +304,17 @@ namespace
 
         return false;
     }
+
+    // Release a fence that no context could take ownership of
+    void closeFence(int fence)
+    {
+    #if defined(SFML_SYSTEM_LINUX) || defined(SFML_SYSTEM_FREEBSD) || defined(SFML_SYSTEM_OPENBSD)
+        if (fence >= 0)
+            close(fence);
+    #else
+        (void)fence;
+    #endif
+    }
 }
 
 
@@ -556,6 +569,90 @@ Uint64 GlContext::getActiveContextId()
 }
 
 
+////////////////////////////////////////////////////////////
+ContextSettings GlContext::getActiveContextSettings()
+{
+    return currentContext ? currentContext->m_settings : ContextSettings();
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::exportTexture(unsigned int texture, DmaBuf& buffer)
+{
+    return currentContext && currentContext->exportDmaBuf(texture, buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::importTexture(const DmaBuf& buffer)
+{
+    return currentContext && currentContext->importDmaBuf(buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::importTexture(void* image)
+{
+    return currentContext && currentContext->importImage(image);
+}
+
+
+////////////////////////////////////////////////////////////
+int GlContext::createFence()
+{
+    return currentContext ? currentContext->insertFence() : -1;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::waitFence(int fence)
+{
+    if (!currentContext)
+    {
+        closeFence(fence);
+        return false;
+    }
+
+    return currentContext->waitForFence(fence);
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::exportDmaBuf(unsigned int /*texture*/, DmaBuf& /*buffer*/)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::importDmaBuf(const DmaBuf& /*buffer*/)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::importImage(void* /*image*/)
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+int GlContext::insertFence()
+{
+    return -1;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContext::waitForFence(int fence)
+{
+    closeFence(fence);
+    return false;
+}
+
+
 ////////////////////////////////////////////////////////////
 GlContext::~GlContext()
 {
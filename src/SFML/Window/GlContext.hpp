@@ -168,6 +168,63 @@ public:
     ////////////////////////////////////////////////////////////
     static Uint64 getActiveContextId();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the settings of the currently active context
+    ///
+    /// \return Settings of the active context, or default settings if no context is currently active
+    ///
+    ////////////////////////////////////////////////////////////
+    static ContextSettings getActiveContextSettings();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Export a texture of the active context as a DMA buffer
+    ///
+    /// \param texture OpenGL name of the texture to export
+    /// \param buffer  Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false if no context is active or DMA buffers aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool exportTexture(unsigned int texture, DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the storage of the bound texture of the active context
+    ///
+    /// \param buffer Description of the DMA buffer to import
+    ///
+    /// \return True on success, false if no context is active or DMA buffers aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool importTexture(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the storage of the bound texture of the active context
+    ///
+    /// \param image EGLImage to import
+    ///
+    /// \return True on success, false if no context is active or EGL images aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool importTexture(void* image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a fence after the commands of the active context
+    ///
+    /// \return File descriptor of the fence, -1 if no context is active or fences aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static int createFence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the active context wait for a fence
+    ///
+    /// \param fence File descriptor of the fence, owned by the function
+    ///
+    /// \return True on success, false if no context is active or fences aren't supported
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool waitFence(int fence);
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -221,6 +278,59 @@ public:
     ////////////////////////////////////////////////////////////
     virtual void setVerticalSyncEnabled(bool enabled) = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Export a texture as a DMA buffer
+    ///
+    /// The default implementations of this function and the
+    /// following ones don't support DMA buffers, EGL images
+    /// nor fences.
+    ///
+    /// \param texture OpenGL name of the texture to export
+    /// \param buffer  Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool exportDmaBuf(unsigned int texture, DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the storage of the bound texture
+    ///
+    /// \param buffer Description of the DMA buffer to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importDmaBuf(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the storage of the bound texture
+    ///
+    /// \param image EGLImage to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importImage(void* image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a fence after the commands issued so far
+    ///
+    /// \return File descriptor of the fence, -1 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual int insertFence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a fence before executing the next commands
+    ///
+    /// \param fence File descriptor of the fence, owned by the function
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool waitForFence(int fence);
+
 protected:
 
     ////////////////////////////////////////////////////////////
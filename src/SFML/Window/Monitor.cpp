@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2020 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/Monitor.hpp>
+#include <SFML/Window/VideoModeImpl.hpp>
+#include <algorithm>
+#include <functional>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+Monitor::Monitor() :
+position    (0, 0),
+physicalSize(0, 0),
+dpi         (0, 0),
+scale       (1),
+refreshRate (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> Monitor::getMonitors()
+{
+    std::vector<Monitor> monitors = priv::VideoModeImpl::getMonitors();
+
+    if (monitors.empty())
+    {
+        // The platform can't enumerate monitors: describe the desktop as a whole
+        Monitor monitor;
+        monitor.desktopMode = VideoMode::getDesktopMode();
+        monitor.modes = VideoMode::getFullscreenModes();
+        monitors.push_back(monitor);
+    }
+
+    for (std::vector<Monitor>::iterator it = monitors.begin(); it != monitors.end(); ++it)
+        std::sort(it->modes.begin(), it->modes.end(), std::greater<VideoMode>());
+
+    return monitors;
+}
+
+} // namespace sf
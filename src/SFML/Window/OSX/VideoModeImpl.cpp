@@ -94,6 +94,14 @@ VideoMode VideoModeImpl::getDesktopMode()
     return mode;
 }
 
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImpl::getMonitors()
+{
+    // Monitors are not enumerated yet, Monitor::getMonitors describes the desktop instead
+    return std::vector<Monitor>();
+}
+
 } // namespace priv
 } // namespace sf
 
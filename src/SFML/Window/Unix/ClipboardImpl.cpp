@@ -48,6 +48,20 @@ String ClipboardImpl::getString()
 }
 
 
+////////////////////////////////////////////////////////////
+void ClipboardImpl::requestString(Clipboard::StringCallback callback, void* userData)
+{
+    DisplayType displayType = getDisplayType();
+    if (displayType == Wayland) {
+        ClipboardImplWayland::requestString(callback, userData);
+    } else {
+        // X11 transfers are handled synchronously
+        callback(ClipboardImplX11::getString(), userData);
+    }
+    unrefDisplay();
+}
+
+
 ////////////////////////////////////////////////////////////
 void ClipboardImpl::setString(const String& text)
 {
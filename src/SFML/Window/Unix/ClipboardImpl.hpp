@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML/Window/Clipboard.hpp>
 #include <SFML/System/String.hpp>
 
 
@@ -56,6 +57,15 @@ public:
     ////////////////////////////////////////////////////////////
     static String getString();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Request the content of the clipboard as string data
+    ///
+    /// \param callback Function to call with the clipboard contents
+    /// \param userData User data passed to the callback
+    ///
+    ////////////////////////////////////////////////////////////
+    static void requestString(Clipboard::StringCallback callback, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the content of the clipboard as string data
     ///
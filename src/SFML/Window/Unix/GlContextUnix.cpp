@@ -44,8 +44,10 @@ GlContextUnix::GlContextUnix(GlContextUnix* shared) {
     DisplayType displayType = getDisplayType();
     if (displayType == Wayland) {
         m_wayland = new GlContextWayland(shared ? shared->m_wayland : NULL);
+        m_settings = m_wayland->getSettings();
     } else {
         m_x11 = new GlxContext(shared ? shared->m_x11 : NULL);
+        m_settings = m_x11->getSettings();
     }
     unrefDisplay();
 }
@@ -55,8 +57,10 @@ GlContextUnix::GlContextUnix(GlContextUnix* shared, const ContextSettings& setti
     DisplayType displayType = getDisplayType();
     if (displayType == Wayland) {
         m_wayland = new GlContextWayland(shared ? shared->m_wayland : NULL, settings, owner, bitsPerPixel);
+        m_settings = m_wayland->getSettings();
     } else {
         m_x11 = new GlxContext(shared ? shared->m_x11 : NULL, settings, owner, bitsPerPixel);
+        m_settings = m_x11->getSettings();
     }
     unrefDisplay();
 }
@@ -66,8 +70,10 @@ GlContextUnix::GlContextUnix(GlContextUnix* shared, const ContextSettings& setti
     DisplayType displayType = getDisplayType();
     if (displayType == Wayland) {
         m_wayland = new GlContextWayland(shared ? shared->m_wayland : NULL, settings, width, height);
+        m_settings = m_wayland->getSettings();
     } else {
         m_x11 = new GlxContext(shared ? shared->m_x11 : NULL, settings, width, height);
+        m_settings = m_x11->getSettings();
     }
     unrefDisplay();
 }
@@ -147,6 +153,76 @@ void GlContextUnix::setVerticalSyncEnabled(bool enabled) {
     }
 }
 
+////////////////////////////////////////////////////////////
+/// \brief Export a texture as a DMA buffer
+///
+////////////////////////////////////////////////////////////
+bool GlContextUnix::exportDmaBuf(unsigned int texture, DmaBuf& buffer) {
+    DisplayType displayType = getDisplayType();
+    bool r = false;
+    if (displayType == Wayland) {
+        r = m_wayland->exportDmaBuf(texture, buffer);
+    }
+    unrefDisplay();
+    return r;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Use a DMA buffer as the storage of the bound texture
+///
+////////////////////////////////////////////////////////////
+bool GlContextUnix::importDmaBuf(const DmaBuf& buffer) {
+    DisplayType displayType = getDisplayType();
+    bool r = false;
+    if (displayType == Wayland) {
+        r = m_wayland->importDmaBuf(buffer);
+    }
+    unrefDisplay();
+    return r;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Use an EGL image as the storage of the bound texture
+///
+////////////////////////////////////////////////////////////
+bool GlContextUnix::importImage(void* image) {
+    DisplayType displayType = getDisplayType();
+    bool r = false;
+    if (displayType == Wayland) {
+        r = m_wayland->importImage(image);
+    }
+    unrefDisplay();
+    return r;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Create a fence after the commands issued so far
+///
+////////////////////////////////////////////////////////////
+int GlContextUnix::insertFence() {
+    DisplayType displayType = getDisplayType();
+    int r = -1;
+    if (displayType == Wayland) {
+        r = m_wayland->insertFence();
+    }
+    unrefDisplay();
+    return r;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Wait for a fence before executing the next commands
+///
+////////////////////////////////////////////////////////////
+bool GlContextUnix::waitForFence(int fence) {
+    DisplayType displayType = getDisplayType();
+    bool r = false;
+    if (displayType == Wayland) {
+        r = m_wayland->waitForFence(fence);
+    }
+    unrefDisplay();
+    return r;
+}
+
 
 } // namespace priv
 
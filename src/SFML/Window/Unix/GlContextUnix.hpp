@@ -123,6 +123,55 @@ public:
     ////////////////////////////////////////////////////////////
     virtual void setVerticalSyncEnabled(bool enabled);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Export a texture as a DMA buffer
+    ///
+    /// \param texture OpenGL name of the texture to export
+    /// \param buffer  Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool exportDmaBuf(unsigned int texture, DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the storage of the bound texture
+    ///
+    /// \param buffer Description of the DMA buffer to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importDmaBuf(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the storage of the bound texture
+    ///
+    /// \param image EGLImage to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importImage(void* image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a fence after the commands issued so far
+    ///
+    /// \return File descriptor of the fence, -1 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual int insertFence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a fence before executing the next commands
+    ///
+    /// \param fence File descriptor of the fence, owned by the function
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool waitForFence(int fence);
+
 private:
     union {
         GlxContext* m_x11;
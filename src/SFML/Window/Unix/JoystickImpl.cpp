@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <cstring>
@@ -51,6 +52,8 @@ namespace
     typedef std::vector<JoystickRecord> JoystickList;
     JoystickList joystickList;
 
+    std::vector<int> openedFiles;
+
     bool isJoystick(udev_device* udevDevice)
     {
         // If anything goes wrong, we go safe and return true
@@ -262,6 +265,24 @@ namespace
                FD_ISSET(monitorFd, &descriptorSet);
     }
 
+    // Apply all the pending connections and disconnections reported by the udev monitor
+    void processMonitorEvents()
+    {
+        while (hasMonitorEvent())
+        {
+            udev_device* udevDevice = udev_monitor_receive_device(udevMonitor);
+
+            // If we can get the specific device, we check that,
+            // otherwise just do a full scan and stop there
+            updatePluggedList(udevDevice);
+
+            if (!udevDevice)
+                break;
+
+            udev_device_unref(udevDevice);
+        }
+    }
+
     // Get a property value from a udev device
     const char* getUdevAttribute(udev_device* udevDevice, const std::string& attributeName)
     {
@@ -513,6 +534,24 @@ void JoystickImpl::cleanup()
 }
 
 
+////////////////////////////////////////////////////////////
+bool JoystickImpl::getFileDescriptors(std::vector<int>& descriptors)
+{
+    descriptors.insert(descriptors.end(), openedFiles.begin(), openedFiles.end());
+
+    // Without a udev monitor, connections can only be found by scanning
+    if (!udevMonitor)
+        return false;
+
+    // The monitor must not be readable already, or waiting on it would return
+    // immediately: the connected slots never read it through isConnected
+    processMonitorEvents();
+
+    descriptors.push_back(udev_monitor_get_fd(udevMonitor));
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool JoystickImpl::isConnected(unsigned int index)
 {
@@ -522,17 +561,10 @@ bool JoystickImpl::isConnected(unsigned int index)
         // udev monitor is not available, perform a scan every query
         updatePluggedList();
     }
-    else if (hasMonitorEvent())
+    else
     {
         // Check if new joysticks were added/removed since last update
-        udev_device* udevDevice = udev_monitor_receive_device(udevMonitor);
-
-        // If we can get the specific device, we check that,
-        // otherwise just do a full scan if udevDevice == NULL
-        updatePluggedList(udevDevice);
-
-        if (udevDevice)
-            udev_device_unref(udevDevice);
+        processMonitorEvents();
     }
 
     if (index >= joystickList.size())
@@ -571,6 +603,8 @@ bool JoystickImpl::open(unsigned int index)
             // Reset the joystick state
             m_state = JoystickState();
 
+            openedFiles.push_back(m_file);
+
             return true;
         }
         else
@@ -586,6 +620,8 @@ bool JoystickImpl::open(unsigned int index)
 ////////////////////////////////////////////////////////////
 void JoystickImpl::close()
 {
+    openedFiles.erase(std::remove(openedFiles.begin(), openedFiles.end(), m_file), openedFiles.end());
+
     ::close(m_file);
     m_file = -1;
 }
@@ -30,6 +30,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Window/JoystickImpl.hpp>
 #include <linux/input.h>
+#include <vector>
 
 
 namespace sf
@@ -62,6 +63,22 @@ public:
     ////////////////////////////////////////////////////////////
     static void cleanup();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the file descriptors that signal joystick activity
+    ///
+    /// The returned descriptors (the udev monitor and the device
+    /// files of the open joysticks) become readable whenever a
+    /// joystick is connected, disconnected or changes its state,
+    /// which allows event loops to wait on them instead of polling.
+    ///
+    /// \param descriptors Vector to append the file descriptors to
+    ///
+    /// \return True if all joystick changes are signalled through the
+    ///         descriptors, false if joysticks still need to be polled
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool getFileDescriptors(std::vector<int>& descriptors);
+
     ////////////////////////////////////////////////////////////
     /// \brief Check if a joystick is currently connected
     ///
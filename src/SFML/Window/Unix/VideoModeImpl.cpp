@@ -75,6 +75,24 @@ VideoMode VideoModeImpl::getDesktopMode() {
     return r;
 }
 
+
+////////////////////////////////////////////////////////////
+/// \brief Get the list of the connected monitors
+///
+/// \return Array filled with the monitors, or empty if the
+///         display server can't enumerate them
+///
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImpl::getMonitors() {
+    std::vector<Monitor> r;
+    DisplayType displayType = getDisplayType();
+    if (displayType == Wayland) {
+        r = VideoModeImplWayland::getMonitors();
+    }
+    unrefDisplay();
+    return r;
+}
+
 } // namespace priv
 
 } // namespace sf
@@ -29,12 +29,179 @@
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
 #include <SFML/System/Clock.hpp>
 #include <SFML/System/Err.hpp>
-#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+
+namespace
+{
+    // Amount of data moved through a pipe at once
+    const std::size_t chunkSize = 65536;
+
+    // Number of chunks moved per pipe and per call to processEvents, so that
+    // multi-megabyte transfers are spread over several frames
+    const int chunksPerCall = 16;
+
+    // Text types, by order of preference
+    const char* const textMimeTypes[] = {
+        "text/plain;charset=utf-8",
+        "UTF8_STRING",
+        "text/plain",
+        "STRING",
+        "TEXT"
+    };
+
+    int getTextMimeTypeRank(const std::string& mimeType)
+    {
+        for (int i = 0; i < static_cast<int>(sizeof(textMimeTypes) / sizeof(textMimeTypes[0])); ++i)
+        {
+            if (mimeType == textMimeTypes[i])
+                return i;
+        }
+        return -1;
+    }
+
+    // Write to a pipe whose reader may have gone away, without dying from SIGPIPE
+    ssize_t writeToPipe(int fd, const char* data, std::size_t size)
+    {
+        sigset_t sigpipe, oldMask;
+        sigemptyset(&sigpipe);
+        sigaddset(&sigpipe, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &sigpipe, &oldMask);
+
+        ssize_t count = write(fd, data, size);
+
+        // Consume the signal raised by this write, unless the application blocks it itself
+        if ((count < 0) && (errno == EPIPE) && !sigismember(&oldMask, SIGPIPE))
+        {
+            struct timespec zero = {0, 0};
+            sigtimedwait(&sigpipe, NULL, &zero);
+            errno = EPIPE;
+        }
+
+        pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+        return count;
+    }
+}
+
 
 namespace sf
 {
 namespace priv
 {
+void data_offer_offer(void *data,
+                      struct wl_data_offer *wl_data_offer,
+                      const char *mime_type) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandOfferMimeType(wl_data_offer, mime_type);
+}
+
+void data_offer_source_actions(void *data,
+                               struct wl_data_offer *wl_data_offer,
+                               uint32_t source_actions) {
+    // Drag and drop is not supported
+}
+
+void data_offer_action(void *data,
+                       struct wl_data_offer *wl_data_offer,
+                       uint32_t dnd_action) {
+    // Drag and drop is not supported
+}
+
+static const struct wl_data_offer_listener data_offer_listener = {
+    data_offer_offer,
+    data_offer_source_actions,
+    data_offer_action
+};
+
+void data_device_data_offer(void *data,
+                            struct wl_data_device *wl_data_device,
+                            struct wl_data_offer *id) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandDataOffer(id);
+}
+
+void data_device_enter(void *data,
+                       struct wl_data_device *wl_data_device,
+                       uint32_t serial,
+                       struct wl_surface *surface,
+                       wl_fixed_t x,
+                       wl_fixed_t y,
+                       struct wl_data_offer *id) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandDndOffer(id);
+}
+
+void data_device_leave(void *data,
+                       struct wl_data_device *wl_data_device) {
+}
+
+void data_device_motion(void *data,
+                        struct wl_data_device *wl_data_device,
+                        uint32_t time,
+                        wl_fixed_t x,
+                        wl_fixed_t y) {
+}
+
+void data_device_drop(void *data,
+                      struct wl_data_device *wl_data_device) {
+}
+
+void data_device_selection(void *data,
+                           struct wl_data_device *wl_data_device,
+                           struct wl_data_offer *id) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandSelection(id);
+}
+
+static const struct wl_data_device_listener data_device_listener = {
+    data_device_data_offer,
+    data_device_enter,
+    data_device_leave,
+    data_device_motion,
+    data_device_drop,
+    data_device_selection
+};
+
+void data_source_target(void *data,
+                        struct wl_data_source *wl_data_source,
+                        const char *mime_type) {
+}
+
+void data_source_send(void *data,
+                      struct wl_data_source *wl_data_source,
+                      const char *mime_type,
+                      int32_t fd) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandSourceSend(wl_data_source, mime_type, fd);
+}
+
+void data_source_cancelled(void *data,
+                           struct wl_data_source *wl_data_source) {
+    static_cast<ClipboardImplWayland*>(data)->handleWaylandSourceCancelled(wl_data_source);
+}
+
+void data_source_dnd_drop_performed(void *data,
+                                    struct wl_data_source *wl_data_source) {
+}
+
+void data_source_dnd_finished(void *data,
+                              struct wl_data_source *wl_data_source) {
+}
+
+void data_source_action(void *data,
+                        struct wl_data_source *wl_data_source,
+                        uint32_t dnd_action) {
+}
+
+static const struct wl_data_source_listener data_source_listener = {
+    data_source_target,
+    data_source_send,
+    data_source_cancelled,
+    data_source_dnd_drop_performed,
+    data_source_dnd_finished,
+    data_source_action
+};
+
 
 ////////////////////////////////////////////////////////////
 String ClipboardImplWayland::getString()
@@ -43,6 +210,13 @@ String ClipboardImplWayland::getString()
 }
 
 
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::requestString(Clipboard::StringCallback callback, void* userData)
+{
+    getInstance().requestStringImpl(callback, userData);
+}
+
+
 ////////////////////////////////////////////////////////////
 void ClipboardImplWayland::setString(const String& text)
 {
@@ -57,20 +231,71 @@ void ClipboardImplWayland::processEvents()
 }
 
 
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::getPollDescriptors(std::vector<pollfd>& descriptors)
+{
+    ClipboardImplWayland& instance = getInstance();
+
+    pollfd descriptor;
+    descriptor.revents = 0;
+
+    if (instance.m_readFd >= 0)
+    {
+        descriptor.fd     = instance.m_readFd;
+        descriptor.events = POLLIN;
+        descriptors.push_back(descriptor);
+    }
+
+    for (std::vector<Transfer>::const_iterator it = instance.m_transfers.begin(); it != instance.m_transfers.end(); ++it)
+    {
+        descriptor.fd     = it->fd;
+        descriptor.events = POLLOUT;
+        descriptors.push_back(descriptor);
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 ClipboardImplWayland::ClipboardImplWayland() :
-//m_window (0),
-m_requestResponded(false)
+m_display      (OpenWaylandDisplay()),
+m_dataDevice   (NULL),
+m_selection    (NULL),
+m_source       (NULL),
+m_contentsValid(false),
+m_readFd       (-1)
 {
-    // Open a connection with the X server
-    m_display = OpenWaylandDisplay();
+    // Without a seat or a data device manager, the clipboard stays empty
+    if (!m_display->data_device_manager || !m_display->seat)
+    {
+        err() << "Wayland compositor has no seat or data device manager, the clipboard is unavailable" << std::endl;
+        return;
+    }
 
+    m_dataDevice = wl_data_device_manager_get_data_device(m_display->data_device_manager, m_display->seat);
+    wl_data_device_add_listener(m_dataDevice, &data_device_listener, this);
+
+    // Receive the current selection
+    wl_display_roundtrip(m_display->display);
 }
 
 
 ////////////////////////////////////////////////////////////
 ClipboardImplWayland::~ClipboardImplWayland()
 {
+    cancelRead();
+
+    for (std::vector<Transfer>::iterator it = m_transfers.begin(); it != m_transfers.end(); ++it)
+        close(it->fd);
+
+    for (std::map<struct wl_data_offer*, std::string>::iterator it = m_offerMimeTypes.begin(); it != m_offerMimeTypes.end(); ++it)
+        wl_data_offer_destroy(it->first);
+
+    if (m_source)
+        wl_data_source_destroy(m_source);
+
+    if (m_dataDevice)
+        wl_data_device_destroy(m_dataDevice);
+
     CloseWaylandDisplay(m_display);
 }
 
@@ -87,19 +312,311 @@ ClipboardImplWayland& ClipboardImplWayland::getInstance()
 ////////////////////////////////////////////////////////////
 String ClipboardImplWayland::getStringImpl()
 {
-    return String();
+    if (m_contentsValid)
+        return m_clipboardContents;
+
+    if ((m_readFd < 0) && !startRead())
+        return String();
+
+    Clock clock;
+
+    // Wait for the contents for up to 1000ms
+    while ((m_readFd >= 0) && (clock.getElapsedTime().asMilliseconds() < 1000))
+    {
+        pollfd descriptor;
+        descriptor.fd      = m_readFd;
+        descriptor.events  = POLLIN;
+        descriptor.revents = 0;
+        poll(&descriptor, 1, std::max(1000 - static_cast<int>(clock.getElapsedTime().asMilliseconds()), 1));
+
+        continueRead();
+    }
+
+    // If the contents did not arrive within the time period, leave them
+    // to the pending requests, if any
+    if (!m_contentsValid)
+    {
+        if (m_requests.empty())
+            cancelRead();
+
+        return String();
+    }
+
+    return m_clipboardContents;
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::requestStringImpl(Clipboard::StringCallback callback, void* userData)
+{
+    if (m_contentsValid)
+    {
+        callback(m_clipboardContents, userData);
+        return;
+    }
+
+    Request request;
+    request.callback = callback;
+    request.userData = userData;
+    m_requests.push_back(request);
+
+    if ((m_readFd < 0) && !startRead())
+        completeRead(String());
 }
 
 
 ////////////////////////////////////////////////////////////
 void ClipboardImplWayland::setStringImpl(const String& text)
 {
+    if (!m_dataDevice)
+        return;
+
+    if (m_source)
+        wl_data_source_destroy(m_source);
+
+    std::basic_string<Uint8> utf8 = text.toUtf8();
+    m_sourceData.assign(utf8.begin(), utf8.end());
+
+    m_source = wl_data_device_manager_create_data_source(m_display->data_device_manager);
+    wl_data_source_add_listener(m_source, &data_source_listener, this);
+    wl_data_source_offer(m_source, "text/plain;charset=utf-8");
+    wl_data_source_offer(m_source, "UTF8_STRING");
+
+    // The compositor only accepts the selection from a client which has
+    // recently received input
+    wl_data_device_set_selection(m_dataDevice, m_source, m_display->input_serial);
+    wl_display_flush(m_display->display);
+
+    // Anybody waiting for the previous contents gets the new ones
+    cancelRead();
+    completeRead(text);
 }
 
 
 ////////////////////////////////////////////////////////////
 void ClipboardImplWayland::processEventsImpl()
 {
+    continueRead();
+    continueWrites();
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandDataOffer(struct wl_data_offer* offer)
+{
+    m_offerMimeTypes[offer] = std::string();
+    wl_data_offer_add_listener(offer, &data_offer_listener, this);
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandOfferMimeType(struct wl_data_offer* offer, const char* mimeType)
+{
+    std::map<struct wl_data_offer*, std::string>::iterator it = m_offerMimeTypes.find(offer);
+    if (it == m_offerMimeTypes.end())
+        return;
+
+    int rank = getTextMimeTypeRank(mimeType);
+    if ((rank >= 0) && (it->second.empty() || (rank < getTextMimeTypeRank(it->second))))
+        it->second = mimeType;
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandDndOffer(struct wl_data_offer* offer)
+{
+    // Drag and drop is not supported, we have no use for the offer
+    if (offer)
+    {
+        m_offerMimeTypes.erase(offer);
+        wl_data_offer_destroy(offer);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandSelection(struct wl_data_offer* offer)
+{
+    if (m_selection && (m_selection != offer))
+    {
+        cancelRead();
+        m_offerMimeTypes.erase(m_selection);
+        wl_data_offer_destroy(m_selection);
+    }
+
+    m_selection = offer;
+
+    // While we own the selection, the offer is our own data source
+    if (m_source)
+        return;
+
+    m_contentsValid = false;
+    m_clipboardContents.clear();
+
+    if (!m_requests.empty() && (m_readFd < 0) && !startRead())
+        completeRead(String());
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandSourceSend(struct wl_data_source* source, const char* mimeType, int fd)
+{
+    if (source != m_source)
+    {
+        close(fd);
+        return;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    Transfer transfer;
+    transfer.fd     = fd;
+    transfer.data   = m_sourceData;
+    transfer.offset = 0;
+    m_transfers.push_back(transfer);
+
+    // Small contents are sent right away
+    continueWrites();
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::handleWaylandSourceCancelled(struct wl_data_source* source)
+{
+    wl_data_source_destroy(source);
+
+    // Another client took over the selection
+    if (source == m_source)
+    {
+        m_source = NULL;
+        m_sourceData.clear();
+        m_contentsValid = false;
+        m_clipboardContents.clear();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool ClipboardImplWayland::startRead()
+{
+    if (!m_selection)
+        return false;
+
+    // Only text can be pasted
+    const std::string& mimeType = m_offerMimeTypes[m_selection];
+    if (mimeType.empty())
+        return false;
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        err() << "Failed to create a pipe to receive the clipboard contents" << std::endl;
+        return false;
+    }
+
+    wl_data_offer_receive(m_selection, mimeType.c_str(), fds[1]);
+    wl_display_flush(m_display->display);
+    close(fds[1]);
+
+    m_readFd = fds[0];
+    m_readBuffer.clear();
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::cancelRead()
+{
+    if (m_readFd >= 0)
+    {
+        close(m_readFd);
+        m_readFd = -1;
+    }
+    std::string().swap(m_readBuffer);
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::continueRead()
+{
+    for (int i = 0; (i < chunksPerCall) && (m_readFd >= 0); ++i)
+    {
+        std::size_t size = m_readBuffer.size();
+        m_readBuffer.resize(size + chunkSize);
+        ssize_t count = read(m_readFd, &m_readBuffer[size], chunkSize);
+        m_readBuffer.resize(size + std::max<ssize_t>(count, 0));
+
+        if (count > 0)
+            continue;
+
+        if ((count < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+            return;
+
+        if ((count < 0) && (errno == EINTR))
+            continue;
+
+        // The whole contents were received, or the transfer failed
+        String text;
+        if (count == 0)
+            text = String::fromUtf8(m_readBuffer.begin(), m_readBuffer.end());
+        else
+            err() << "Failed to read the clipboard contents: " << std::strerror(errno) << std::endl;
+
+        cancelRead();
+        completeRead(text);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::continueWrites()
+{
+    std::vector<Transfer>::iterator it = m_transfers.begin();
+    while (it != m_transfers.end())
+    {
+        bool finished = false;
+        for (int i = 0; (i < chunksPerCall) && !finished; ++i)
+        {
+            std::size_t size = std::min(chunkSize, it->data.size() - it->offset);
+            if (size == 0)
+            {
+                finished = true;
+                break;
+            }
+
+            ssize_t count = writeToPipe(it->fd, &it->data[it->offset], size);
+            if (count > 0)
+                it->offset += static_cast<std::size_t>(count);
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                break;
+            else if (errno != EINTR)
+                finished = true; // The receiver went away
+        }
+
+        if (finished)
+        {
+            close(it->fd);
+            it = m_transfers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ClipboardImplWayland::completeRead(const String& text)
+{
+    m_clipboardContents = text;
+    m_contentsValid = true;
+
+    // The callbacks may request the contents again
+    std::vector<Request> requests;
+    requests.swap(m_requests);
+    for (std::vector<Request>::const_iterator it = requests.begin(); it != requests.end(); ++it)
+        it->callback(text, it->userData);
 }
 
 } // namespace priv
@@ -28,9 +28,13 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML/Window/Clipboard.hpp>
 #include <SFML/System/String.hpp>
-#include <deque>
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include <poll.h>
 
 
 namespace sf
@@ -41,6 +45,11 @@ namespace priv
 ////////////////////////////////////////////////////////////
 /// \brief Give access to the system clipboard
 ///
+/// Clipboard contents travel through pipes between the
+/// clients. Both ends are non-blocking and are serviced a
+/// chunk at a time from the window event processing, so
+/// that large transfers never stall the application.
+///
 ////////////////////////////////////////////////////////////
 class ClipboardImplWayland
 {
@@ -58,6 +67,15 @@ public:
     ////////////////////////////////////////////////////////////
     static String getString();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Request the content of the clipboard as string data
+    ///
+    /// \param callback Function to call with the clipboard contents
+    /// \param userData User data passed to the callback
+    ///
+    ////////////////////////////////////////////////////////////
+    static void requestString(Clipboard::StringCallback callback, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the content of the clipboard as string data
     ///
@@ -71,17 +89,57 @@ public:
     static void setString(const String& text);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Process pending events for the hidden clipboard window
+    /// \brief Process pending clipboard transfers
     ///
     /// This function has to be called as part of normal window
     /// event processing in order for our application to respond
-    /// to selection requests from other applications.
+    /// to selection requests from other applications, and to
+    /// receive the contents we requested.
     ///
     ////////////////////////////////////////////////////////////
     static void processEvents();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the pipes of the pending transfers
+    ///
+    /// Waiting for events must also wait for these, so that
+    /// transfers make progress while the application sleeps.
+    ///
+    /// \param descriptors Vector to append the pipes to
+    ///
+    ////////////////////////////////////////////////////////////
+    static void getPollDescriptors(std::vector<pollfd>& descriptors);
+
+    void handleWaylandDataOffer(struct wl_data_offer* offer);
+    void handleWaylandOfferMimeType(struct wl_data_offer* offer, const char* mimeType);
+    void handleWaylandDndOffer(struct wl_data_offer* offer);
+    void handleWaylandSelection(struct wl_data_offer* offer);
+    void handleWaylandSourceSend(struct wl_data_source* source, const char* mimeType, int fd);
+    void handleWaylandSourceCancelled(struct wl_data_source* source);
+
 private:
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Contents being written to another client
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Transfer
+    {
+        int         fd;     ///< Non-blocking write end of the pipe
+        std::string data;   ///< UTF-8 contents to write
+        std::size_t offset; ///< Number of bytes already written
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Function waiting for the clipboard contents
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Request
+    {
+        Clipboard::StringCallback callback; ///< Function to call
+        void*                     userData; ///< User data for the function
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Constructor
     ///
@@ -110,6 +168,15 @@ private:
     ////////////////////////////////////////////////////////////
     String getStringImpl();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief requestString implementation
+    ///
+    /// \param callback Function to call with the clipboard contents
+    /// \param userData User data passed to the callback
+    ///
+    ////////////////////////////////////////////////////////////
+    void requestStringImpl(Clipboard::StringCallback callback, void* userData);
+
     ////////////////////////////////////////////////////////////
     /// \brief setString implementation
     ///
@@ -125,26 +192,54 @@ private:
     void processEventsImpl();
 
     ////////////////////////////////////////////////////////////
-    /// \brief Process an incoming event from the window
+    /// \brief Ask the owner of the selection to send its contents
+    ///
+    /// \return True if a read is in progress
+    ///
+    ////////////////////////////////////////////////////////////
+    bool startRead();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Abort the read in progress, if any
+    ///
+    ////////////////////////////////////////////////////////////
+    void cancelRead();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read what is available of the selection contents
+    ///
+    ////////////////////////////////////////////////////////////
+    void continueRead();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write what the pipes accept of the transfers
+    ///
+    ////////////////////////////////////////////////////////////
+    void continueWrites();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the received contents and call the waiting functions
     ///
-    /// \param windowEvent Event which has been received
+    /// \param text Content of the clipboard
     ///
     ////////////////////////////////////////////////////////////
-//    void processEvent(XEvent& windowEvent);
+    void completeRead(const String& text);
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-//    ::Window           m_window;            ///< X identifier defining our window
-    WaylandDisplay*         m_display;           ///< Pointer to the display
-//    Atom               m_clipboard;         ///< X Atom identifying the CLIPBOARD selection
-//    Atom               m_targets;           ///< X Atom identifying TARGETS
-//    Atom               m_text;              ///< X Atom identifying TEXT
-//    Atom               m_utf8String;        ///< X Atom identifying UTF8_STRING
-//    Atom               m_targetProperty;    ///< X Atom identifying our destination window property
-//    String             m_clipboardContents; ///< Our clipboard contents
-//    std::deque<XEvent> m_events;            ///< Queue we use to store pending events for this window
-    bool               m_requestResponded;  ///< Holds whether our selection request has been responded to or not
+    WaylandDisplay*                              m_display;           ///< Pointer to the display
+    struct wl_data_device*                       m_dataDevice;        ///< Data device of the seat, NULL if the clipboard is unavailable
+    std::map<struct wl_data_offer*, std::string> m_offerMimeTypes;    ///< Best text type of each live offer
+    struct wl_data_offer*                        m_selection;         ///< Offer of the current selection, if any
+    struct wl_data_source*                       m_source;            ///< Our selection, if we own it
+    std::string                                  m_sourceData;        ///< UTF-8 encoding of our contents, while we own the selection
+    String                                       m_clipboardContents; ///< Our clipboard contents, or the received ones
+    bool                                         m_contentsValid;     ///< Does m_clipboardContents match the selection?
+    int                                          m_readFd;            ///< Non-blocking read end of the pipe, or -1
+    std::string                                  m_readBuffer;        ///< UTF-8 contents received so far
+    std::vector<Request>                         m_requests;          ///< Functions waiting for the contents
+    std::vector<Transfer>                        m_transfers;         ///< Contents being sent to other clients
 };
 
 } // namespace priv
@@ -27,9 +27,66 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Window/Unix/Wayland/CursorImplWayland.hpp>
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
-#include <cassert>
-#include <cstdlib>
-#include <vector>
+#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <cstddef>
+
+
+namespace
+{
+    // Names of the cursors in the themes, the freedesktop ones first, then
+    // the older X11 ones; NULL terminated
+    const char* const* getCursorNames(sf::Cursor::Type type)
+    {
+        static const char* const arrow[]                  = {"default", "left_ptr", NULL};
+        static const char* const arrowWait[]              = {"progress", "left_ptr_watch", NULL};
+        static const char* const wait[]                   = {"wait", "watch", NULL};
+        static const char* const text[]                   = {"text", "xterm", NULL};
+        static const char* const hand[]                   = {"pointer", "hand2", "hand1", NULL};
+        static const char* const sizeHorizontal[]         = {"ew-resize", "sb_h_double_arrow", NULL};
+        static const char* const sizeVertical[]           = {"ns-resize", "sb_v_double_arrow", NULL};
+        static const char* const sizeTopLeftBottomRight[] = {"nwse-resize", "bd_double_arrow", NULL};
+        static const char* const sizeBottomLeftTopRight[] = {"nesw-resize", "fd_double_arrow", NULL};
+        static const char* const sizeAll[]                = {"all-scroll", "fleur", NULL};
+        static const char* const cross[]                  = {"crosshair", "cross", NULL};
+        static const char* const help[]                   = {"help", "question_arrow", NULL};
+        static const char* const notAllowed[]             = {"not-allowed", "crossed_circle", NULL};
+
+        switch (type)
+        {
+            default:                                   return NULL;
+            case sf::Cursor::Arrow:                    return arrow;
+            case sf::Cursor::ArrowWait:                return arrowWait;
+            case sf::Cursor::Wait:                     return wait;
+            case sf::Cursor::Text:                     return text;
+            case sf::Cursor::Hand:                     return hand;
+            case sf::Cursor::SizeHorizontal:           return sizeHorizontal;
+            case sf::Cursor::SizeVertical:             return sizeVertical;
+            case sf::Cursor::SizeTopLeftBottomRight:   return sizeTopLeftBottomRight;
+            case sf::Cursor::SizeBottomLeftTopRight:   return sizeBottomLeftTopRight;
+            case sf::Cursor::SizeAll:                  return sizeAll;
+            case sf::Cursor::Cross:                    return cross;
+            case sf::Cursor::Help:                     return help;
+            case sf::Cursor::NotAllowed:               return notAllowed;
+        }
+    }
+
+    struct wl_cursor* findCursor(struct wl_cursor_theme* theme, sf::Cursor::Type type)
+    {
+        const char* const* names = getCursorNames(type);
+        if (!theme || !names)
+            return NULL;
+
+        for (; *names; ++names)
+        {
+            struct wl_cursor* cursor = wl_cursor_theme_get_cursor(theme, *names);
+            if (cursor)
+                return cursor;
+        }
+        return NULL;
+    }
+}
+
 
 namespace sf
 {
@@ -38,7 +95,11 @@ namespace priv
 
 ////////////////////////////////////////////////////////////
 CursorImplWayland::CursorImplWayland() :
-m_display(OpenWaylandDisplay())
+m_display(OpenWaylandDisplay()),
+m_system (false),
+m_type   (Cursor::Arrow),
+m_buffer (NULL),
+m_hotspot(0, 0)
 {
     // That's it.
 }
@@ -47,6 +108,8 @@ m_display(OpenWaylandDisplay())
 ////////////////////////////////////////////////////////////
 CursorImplWayland::~CursorImplWayland()
 {
+    release();
+
     CloseWaylandDisplay(m_display);
 }
 
@@ -54,17 +117,86 @@ CursorImplWayland::~CursorImplWayland()
 ////////////////////////////////////////////////////////////
 bool CursorImplWayland::loadFromPixels(const Uint8* pixels, Vector2u size, Vector2u hotspot)
 {
+    release();
+
+    // The image is uploaded once, displaying the cursor just attaches the buffer
+    m_buffer = CreateWaylandCursorBuffer(m_display, pixels, size.x, size.y);
+    if (!m_buffer)
+        return false;
+
+    m_hotspot = Vector2i(hotspot);
     return true;
 }
 
+
 ////////////////////////////////////////////////////////////
 bool CursorImplWayland::loadFromSystem(Cursor::Type type)
 {
+    release();
+
+    // Make sure the theme has the cursor; its images are loaded with the theme
+    if (!findCursor(GetWaylandCursorTheme(m_display, 1), type))
+        return false;
+
+    m_system = true;
+    m_type = type;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CursorImplWayland::getImage(int scale, Uint32 time, Image& image) const
+{
+    if (m_system)
+        return getSystemImage(m_display, m_type, scale, time, image);
+
+    if (!m_buffer)
+        return false;
+
+    image.buffer = m_buffer;
+    image.hotspot = m_hotspot;
+    image.scale = 1;
+    image.delay = 0;
     return true;
 }
 
 
+////////////////////////////////////////////////////////////
+bool CursorImplWayland::getSystemImage(WaylandDisplay* display, Cursor::Type type, int scale, Uint32 time, Image& image)
+{
+    // The theme is loaded at the size matching the scale, for a sharp cursor
+    struct wl_cursor* cursor = findCursor(GetWaylandCursorTheme(display, scale), type);
+    if (!cursor && (scale != 1))
+    {
+        scale = 1;
+        cursor = findCursor(GetWaylandCursorTheme(display, scale), type);
+    }
+    if (!cursor)
+        return false;
+
+    uint32_t duration = 0;
+    int frame = wl_cursor_frame_and_duration(cursor, time, &duration);
+    struct wl_cursor_image* cursorImage = cursor->images[frame];
+
+    image.buffer = wl_cursor_image_get_buffer(cursorImage);
+    image.hotspot = Vector2i(cursorImage->hotspot_x / scale, cursorImage->hotspot_y / scale);
+    image.scale = scale;
+    image.delay = (cursor->image_count > 1) ? std::max(duration, 1u) : 0;
+    return image.buffer != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void CursorImplWayland::release()
+{
+    if (m_buffer)
+    {
+        DestroyWaylandCursorBuffer(m_display, m_buffer);
+        m_buffer = NULL;
+    }
+    m_system = false;
+}
+
 } // namespace priv
 
 } // namespace sf
-
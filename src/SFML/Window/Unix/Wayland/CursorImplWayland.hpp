@@ -80,13 +80,61 @@ public:
     ////////////////////////////////////////////////////////////
     bool loadFromSystem(Cursor::Type type);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Image of a cursor, ready to be displayed
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Image
+    {
+        struct wl_buffer* buffer;  ///< Buffer holding the image
+        Vector2i          hotspot; ///< Hotspot, in surface coordinates
+        int               scale;   ///< Buffer scale of the image
+        Uint32            delay;   ///< Time until the next frame of an animated cursor, in ms (0 if not animated)
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the image to display
+    ///
+    /// \param scale Integer scale of the outputs showing the cursor
+    /// \param time  Time used to pick the frame of animated cursors, in ms
+    /// \param image Image to fill
+    ///
+    /// \return True if the cursor has an image
+    ///
+    ////////////////////////////////////////////////////////////
+    bool getImage(int scale, Uint32 time, Image& image) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the image of a native system cursor
+    ///
+    /// \param display Display owning the cursor themes
+    /// \param type    Native system cursor type
+    /// \param scale   Integer scale of the outputs showing the cursor
+    /// \param time    Time used to pick the frame of animated cursors, in ms
+    /// \param image   Image to fill
+    ///
+    /// \return True if the cursor theme has the cursor
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool getSystemImage(WaylandDisplay* display, Cursor::Type type, int scale, Uint32 time, Image& image);
+
 private:
     friend class WindowImplWayland;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the cursor, if we have loaded one
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    WaylandDisplay* m_display;
+    WaylandDisplay*   m_display;    ///< Display owning the cursor themes and the image pool
+    bool              m_system;     ///< Is this a native system cursor?
+    Cursor::Type      m_type;       ///< Type of the native system cursor
+    struct wl_buffer* m_buffer;     ///< Image of the custom cursor, if any
+    Vector2i          m_hotspot;    ///< Hotspot of the custom cursor
 };
 
 } // namespace priv
@@ -34,6 +34,7 @@
 #include <EGL/egl.h>
 
 #include <cstring>
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <map>
@@ -43,6 +44,8 @@
 #include <EGL/eglext.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
 
 namespace
 {
@@ -61,32 +64,24 @@ namespace
         wm_base_ping
     };
 
-    sf::priv::WindowImplWayland* window_for_surface(struct wl_surface *surface) {
-        for (sf::priv::WindowImplWayland* w : shared_globals.window_list) {
-            if (w->m_surface == surface) {
-                return w;
-            }
-        }
-        return NULL;
-    }
-
     void pointer_enter(void *data,
               struct wl_pointer *wl_pointer,
               uint32_t serial,
               struct wl_surface *surface,
               wl_fixed_t surface_x,
                   wl_fixed_t surface_y) {
-        sf::priv::WindowImplWayland* window = window_for_surface(surface);
+        sf::priv::WindowImplWayland* window = sf::priv::WindowImplWayland::fromSurface(surface);
         if (window) {
-            window->handleWaylandPointerEnter();
             shared_globals.pointer_focus_window = window;
+            shared_globals.input_serial = serial;
+            window->handleWaylandPointerEnter(serial);
         }
     }
     void pointer_leave(void *data,
               struct wl_pointer *wl_pointer,
               uint32_t serial,
                   struct wl_surface *surface) {
-        sf::priv::WindowImplWayland* window = window_for_surface(surface);
+        sf::priv::WindowImplWayland* window = sf::priv::WindowImplWayland::fromSurface(surface);
         if (window) {
             window->handleWaylandPointerLeave();
             shared_globals.pointer_focus_window = NULL;
@@ -116,7 +111,7 @@ namespace
             if (button >= BTN_MOUSE && button < BTN_MOUSE + 8) {
                 shared_globals.pointer_button_vector[button - BTN_MOUSE] = (state == WL_POINTER_BUTTON_STATE_PRESSED) ? true : false;
             }
-            // TODO: handle serial!
+            shared_globals.input_serial = serial;
             shared_globals.pointer_focus_window->handleWaylandPointerButton(time, button, state);
         }
     }
@@ -133,8 +128,10 @@ namespace
     }
     void pointer_frame(void *data,
                        struct wl_pointer *wl_pointer) {
-        // TODO: is it worth it to coalesce all the pointer info?
-        // (Probably yes, so that we can apply the mouse motion events _first_?)
+        // The focused window accumulates the pointer state until here
+        if (shared_globals.pointer_focus_window) {
+            shared_globals.pointer_focus_window->handleWaylandPointerFrame();
+        }
     }
     void pointer_axis_source(void *data,
                 struct wl_pointer *wl_pointer,
@@ -155,6 +152,22 @@ namespace
             shared_globals.pointer_focus_window->handleWaylandPointerAxisDiscrete(axis, discrete);
         }
     }
+    void relative_pointer_motion(void *data,
+                                 struct zwp_relative_pointer_v1 *relative_pointer,
+                                 uint32_t utime_hi,
+                                 uint32_t utime_lo,
+                                 wl_fixed_t dx,
+                                 wl_fixed_t dy,
+                                 wl_fixed_t dx_unaccel,
+                                 wl_fixed_t dy_unaccel) {
+        if (shared_globals.pointer_focus_window) {
+            shared_globals.pointer_focus_window->handleWaylandPointerRelativeMotion(
+                    wl_fixed_to_double(dx_unaccel), wl_fixed_to_double(dy_unaccel));
+        }
+    }
+    static const struct zwp_relative_pointer_v1_listener relative_pointer_listener = {
+        relative_pointer_motion
+    };
     static const struct wl_pointer_listener pointer_listener = {
         pointer_enter,
         pointer_leave,
@@ -196,26 +209,49 @@ namespace
         shared_globals.keyboard_state = xkb_state_new(shared_globals.keyboard_keymap);
 
     }
+    void set_key_repeat_timer(int delay, int rate) {
+        itimerspec timer;
+        std::memset(&timer, 0, sizeof(timer));
+        if (rate > 0) {
+            timer.it_value.tv_sec = delay / 1000;
+            timer.it_value.tv_nsec = (delay % 1000) * 1000000l;
+            timer.it_interval.tv_nsec = 1000000000l / rate;
+            if (rate == 1) {
+                timer.it_interval.tv_sec = 1;
+                timer.it_interval.tv_nsec = 0;
+            }
+            // A zero it_value would disarm the timer
+            if (delay <= 0)
+                timer.it_value.tv_nsec = 1;
+        }
+        timerfd_settime(shared_globals.keyboard_repeat_fd, 0, &timer, NULL);
+    }
+    void stop_key_repeat() {
+        shared_globals.keyboard_repeat_keycode = 0;
+        set_key_repeat_timer(0, 0);
+    }
     void keyboard_enter(void *data,
               struct wl_keyboard *wl_keyboard,
               uint32_t serial,
               struct wl_surface *surface,
                         struct wl_array *keys) {
-        sf::priv::WindowImplWayland* window = window_for_surface(surface);
+        sf::priv::WindowImplWayland* window = sf::priv::WindowImplWayland::fromSurface(surface);
         if (window) {
             window->handleWaylandKeyboardEnter();
             shared_globals.keyboard_focus_window = window;
+            shared_globals.input_serial = serial;
         }
     }
     void keyboard_leave(void *data,
               struct wl_keyboard *wl_keyboard,
               uint32_t serial,
                         struct wl_surface *surface) {
-        sf::priv::WindowImplWayland* window = window_for_surface(surface);
+        sf::priv::WindowImplWayland* window = sf::priv::WindowImplWayland::fromSurface(surface);
         if (window) {
             window->handleWaylandKeyboardLeave();
             shared_globals.keyboard_focus_window = NULL;
         }
+        stop_key_repeat();
     }
     void keyboard_key(void *data,
             struct wl_keyboard *wl_keyboard,
@@ -227,13 +263,23 @@ namespace
             std::abort();
         }
         uint32_t keycode = key + 8;
+        shared_globals.input_serial = serial;
         if (shared_globals.keyboard_focus_window) {
             // TODO: do we need multikey handling?
             xkb_keysym_t keysym = xkb_state_key_get_one_sym(shared_globals.keyboard_state, keycode);
 
             if (state == WL_KEYBOARD_KEY_STATE_PRESSED) {
                 shared_globals.keyboard_held_keys.push_back(std::pair<uint32_t,uint32_t>(keysym, keycode));
+
+                // The last key pressed is the one that repeats
+                if (xkb_keymap_key_repeats(shared_globals.keyboard_keymap, keycode)) {
+                    shared_globals.keyboard_repeat_keycode = keycode;
+                    set_key_repeat_timer(shared_globals.keyboard_repeat_delay, shared_globals.keyboard_repeat_rate);
+                }
             } else {
+                if (keycode == shared_globals.keyboard_repeat_keycode) {
+                    stop_key_repeat();
+                }
                 // todo: filter operation? what if the same keycode is pressed twice?
                 bool clear = false;
                 while (!clear) {
@@ -282,7 +328,11 @@ namespace
                 struct wl_keyboard *wl_keyboard,
                 int32_t rate,
                               int32_t delay) {
-
+        shared_globals.keyboard_repeat_rate = rate;
+        shared_globals.keyboard_repeat_delay = delay;
+        if (rate <= 0) {
+            stop_key_repeat();
+        }
     }
 
 
@@ -295,22 +345,51 @@ namespace
         keyboard_repeat_info
     };
 
+    void release_pointer() {
+        // The relative pointer goes first, it was created from the pointer
+        if (shared_globals.relative_pointer) {
+            zwp_relative_pointer_v1_destroy(shared_globals.relative_pointer);
+            shared_globals.relative_pointer = NULL;
+        }
+        if (shared_globals.pointer) {
+            wl_pointer_release(shared_globals.pointer);
+            shared_globals.pointer = NULL;
+        }
+        shared_globals.pointer_focus_window = NULL;
+    }
+    void release_keyboard() {
+        if (shared_globals.keyboard) {
+            wl_keyboard_release(shared_globals.keyboard);
+            shared_globals.keyboard = NULL;
+        }
+        stop_key_repeat();
+        shared_globals.keyboard_focus_window = NULL;
+    }
     static void
     seat_capabilities(void *data, struct wl_seat *wl_seat,
                       uint32_t capabilities)
     {
-        if (!(capabilities & WL_SEAT_CAPABILITY_KEYBOARD)) {
-            sf::err() << "We have no keyboard" << std::endl;
-            std::abort();
+        // Capabilities are sent again whenever a device is plugged or unplugged
+        bool hasPointer = (capabilities & WL_SEAT_CAPABILITY_POINTER) != 0;
+        if (hasPointer && !shared_globals.pointer) {
+            shared_globals.pointer = wl_seat_get_pointer(shared_globals.seat);
+            wl_pointer_add_listener(shared_globals.pointer,&pointer_listener, NULL);
+
+            // All globals are bound by the time the capabilities arrive
+            shared_globals.relative_pointer = zwp_relative_pointer_manager_v1_get_relative_pointer(
+                        shared_globals.relative_pointer_manager, shared_globals.pointer);
+            zwp_relative_pointer_v1_add_listener(shared_globals.relative_pointer, &relative_pointer_listener, NULL);
+        } else if (!hasPointer && shared_globals.pointer) {
+            release_pointer();
         }
-        if (!(capabilities & WL_SEAT_CAPABILITY_POINTER)) {
-            sf::err() << "We have no pointer" << std::endl;
-            std::abort();
+
+        bool hasKeyboard = (capabilities & WL_SEAT_CAPABILITY_KEYBOARD) != 0;
+        if (hasKeyboard && !shared_globals.keyboard) {
+            shared_globals.keyboard = wl_seat_get_keyboard(shared_globals.seat);
+            wl_keyboard_add_listener(shared_globals.keyboard,&keyboard_listener, NULL);
+        } else if (!hasKeyboard && shared_globals.keyboard) {
+            release_keyboard();
         }
-        shared_globals.pointer = wl_seat_get_pointer(shared_globals.seat);
-        shared_globals.keyboard = wl_seat_get_keyboard(shared_globals.seat);
-        wl_pointer_add_listener(shared_globals.pointer,&pointer_listener, NULL);
-        wl_keyboard_add_listener(shared_globals.keyboard,&keyboard_listener, NULL);
     }
     void seat_name(void *data,struct wl_seat *wl_seat,const char *name)
     {
@@ -332,7 +411,14 @@ namespace
              const char *make,
              const char *model,
                          int32_t transform) {
-        // todo: expose DPI somehow
+        sf::Lock lock(mutex);
+        sf::priv::WaylandOutput* output = (sf::priv::WaylandOutput*)data;
+        output->x = x;
+        output->y = y;
+        output->physical_width = physical_width;
+        output->physical_height = physical_height;
+        output->make = make ? make : "";
+        output->model = model ? model : "";
     }
     void output_mode(void *data,
              struct wl_output *wl_output,
@@ -340,8 +426,28 @@ namespace
              int32_t width,
              int32_t height,
                      int32_t refresh) {
-        shared_globals.output_width = width;
-        shared_globals.output_height = height;
+        sf::Lock lock(mutex);
+        sf::priv::WaylandOutput* output = (sf::priv::WaylandOutput*)data;
+        bool current = (flags & WL_OUTPUT_MODE_CURRENT) != 0;
+
+        // Modes are sent again when the current one changes
+        sf::priv::WaylandOutputMode* known = NULL;
+        for (std::size_t i = 0; i < output->modes.size(); ++i) {
+            sf::priv::WaylandOutputMode& mode = output->modes[i];
+            if (current)
+                mode.current = false;
+            if (mode.width == width && mode.height == height && mode.refresh == refresh)
+                known = &mode;
+        }
+        if (!known) {
+            sf::priv::WaylandOutputMode mode;
+            mode.width = width;
+            mode.height = height;
+            mode.refresh = refresh;
+            output->modes.push_back(mode);
+            known = &output->modes.back();
+        }
+        known->current = current;
     }
     void output_done(void *data,
                      struct wl_output *wl_output) {
@@ -350,7 +456,9 @@ namespace
     void output_scale(void *data,
               struct wl_output *wl_output,
                       int32_t factor) {
-        shared_globals.output_scale = factor;
+        sf::Lock lock(mutex);
+        sf::priv::WaylandOutput* output = (sf::priv::WaylandOutput*)data;
+        output->scale = factor;
     }
     const struct wl_output_listener output_listener {
         output_geometry,
@@ -359,6 +467,26 @@ namespace
         output_scale,
     };
 
+    void shm_format(void *data,
+                    struct wl_shm *wl_shm,
+                    uint32_t format) {
+        if (format == WL_SHM_FORMAT_XBGR8888) {
+            shared_globals.shm_xbgr8888 = true;
+        }
+    }
+    const struct wl_shm_listener shm_listener {
+        shm_format,
+    };
+
+    void presentation_clock_id(void *data,
+                               struct wp_presentation *wp_presentation,
+                               uint32_t clk_id) {
+        shared_globals.presentation_clock = clk_id;
+    }
+    const struct wp_presentation_listener presentation_listener {
+        presentation_clock_id,
+    };
+
     void registry_global(void *data,
                struct wl_registry *wl_registry,
                uint32_t name,
@@ -367,8 +495,11 @@ namespace
         std::string iface(interface);
         if (iface == "wl_shm") {
             shared_globals.shm = (struct wl_shm*)wl_registry_bind(wl_registry, name, &wl_shm_interface, 1);
+            wl_shm_add_listener(shared_globals.shm, &shm_listener, NULL);
         } else if (iface == "wl_compositor") {
-            shared_globals.compositor = (struct wl_compositor*)wl_registry_bind(wl_registry, name, &wl_compositor_interface, 1);
+            // Version 4 brings wl_surface.damage_buffer
+            shared_globals.compositor_version = std::min(version, 4u);
+            shared_globals.compositor = (struct wl_compositor*)wl_registry_bind(wl_registry, name, &wl_compositor_interface, shared_globals.compositor_version);
         } else if (iface == "wl_data_device_manager") {
             shared_globals.data_device_manager = (struct wl_data_device_manager*)wl_registry_bind(wl_registry, name, &wl_data_device_manager_interface, 1);
         } else  if (iface == "xdg_wm_base") {
@@ -380,26 +511,117 @@ namespace
             shared_globals.pointer_constraints = (struct zwp_pointer_constraints_v1*)wl_registry_bind(wl_registry, name, &zwp_pointer_constraints_v1_interface, 1);
         } else if (iface == "zxdg_decoration_manager_v1") {
             shared_globals.decoration_manager = (struct zxdg_decoration_manager_v1*)wl_registry_bind(wl_registry, name, &zxdg_decoration_manager_v1_interface, 1);
+        } else if (iface == "wp_presentation") {
+            shared_globals.presentation = (struct wp_presentation*)wl_registry_bind(wl_registry, name, &wp_presentation_interface, 1);
+            wp_presentation_add_listener(shared_globals.presentation, &presentation_listener, NULL);
+        } else if (iface == "wp_viewporter") {
+            shared_globals.viewporter = (struct wp_viewporter*)wl_registry_bind(wl_registry, name, &wp_viewporter_interface, 1);
+        } else if (iface == "wp_fractional_scale_manager_v1") {
+            shared_globals.fractional_scale_manager = (struct wp_fractional_scale_manager_v1*)wl_registry_bind(wl_registry, name, &wp_fractional_scale_manager_v1_interface, 1);
+        } else if (iface == "wp_tearing_control_manager_v1") {
+            shared_globals.tearing_control_manager = (struct wp_tearing_control_manager_v1*)wl_registry_bind(wl_registry, name, &wp_tearing_control_manager_v1_interface, 1);
         }else if (iface == "wl_seat") {
             shared_globals.seat = (struct wl_seat*)wl_registry_bind(wl_registry, name, &wl_seat_interface, 7);
             wl_seat_add_listener(shared_globals.seat, &seat_listener, NULL);
         }else if (iface == "wl_output") {
+            sf::Lock lock(mutex);
             // todo: is xdg output also worth using?
-            shared_globals.output = (struct wl_output*)wl_registry_bind(wl_registry, name, &wl_output_interface, 2);
-            wl_output_add_listener(shared_globals.output, &output_listener, NULL);
+            sf::priv::WaylandOutput* output = new sf::priv::WaylandOutput();
+            output->name = name;
+            output->output = (struct wl_output*)wl_registry_bind(wl_registry, name, &wl_output_interface, 2);
+            output->x = 0;
+            output->y = 0;
+            output->physical_width = 0;
+            output->physical_height = 0;
+            output->scale = 1;
+            wl_output_add_listener(output->output, &output_listener, output);
+            shared_globals.outputs.push_back(output);
         }
     }
     void registry_global_remove(void *data,
                   struct wl_registry *wl_registry,
                                 uint32_t name) {
-
+        // Only outputs are expected to come and go
+        sf::Lock lock(mutex);
+        for (std::size_t i = 0; i < shared_globals.outputs.size(); ++i) {
+            sf::priv::WaylandOutput* output = shared_globals.outputs[i];
+            if (output->name != name)
+                continue;
+
+            for (sf::priv::WindowImplWayland* w : shared_globals.window_list) {
+                w->handleWaylandOutputRemoved(output->output);
+            }
+            wl_output_destroy(output->output);
+            delete output;
+            shared_globals.outputs.erase(shared_globals.outputs.begin() + i);
+            break;
+        }
     }
 
     const struct wl_registry_listener registry_listener {
         registry_global, registry_global_remove
     };
 
+    EGLDisplay OpenEglDisplay(struct wl_display* display) {
+        if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE) {
+            sf::err() << "EGL doesn't support OpenGL, OpenGL contexts won't be available" << std::endl;
+            return EGL_NO_DISPLAY;
+        }
+
+        // This is a space-separated list of extensions (NULL without EGL_EXT_client_extensions)
+        const char *extensions_list = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        bool has_ext_platform = extensions_list && strstr(extensions_list, "EGL_EXT_platform_wayland");
+        bool has_khr_platform = extensions_list && strstr(extensions_list, "EGL_KHR_platform_wayland");
+        if (!has_khr_platform && !has_ext_platform) {
+            sf::err() << "EGL doesn't seem to support Wayland, OpenGL contexts won't be available" << std::endl;
+            return EGL_NO_DISPLAY;
+        }
+
+        EGLDisplay egl_dpy = eglGetPlatformDisplay(has_ext_platform ? EGL_PLATFORM_WAYLAND_EXT :EGL_PLATFORM_WAYLAND_KHR, display, NULL);
+        if (egl_dpy == EGL_NO_DISPLAY) {
+            sf::err() << "EGL could not make use of the display, OpenGL contexts won't be available" << std::endl;
+            return EGL_NO_DISPLAY;
+        }
 
+        int major_version = -1, minor_version = -1;
+        if (eglInitialize(egl_dpy, &major_version, &minor_version) == EGL_FALSE) {
+            sf::err() << "Failed to initialize EGL, OpenGL contexts won't be available" << std::endl;
+            return EGL_NO_DISPLAY;
+        }
+
+        return egl_dpy;
+    }
+
+    // The images of all the cursors can't take more than this
+    const std::size_t max_cursor_pool_size = 32 * 1024 * 1024;
+
+    std::vector<sf::priv::WaylandCursorRange>::iterator find_cursor_range(sf::priv::WaylandDisplay* display, struct wl_buffer* buffer) {
+        std::vector<sf::priv::WaylandCursorRange>::iterator it = display->cursor_ranges.begin();
+        while ((it != display->cursor_ranges.end()) && (it->buffer != buffer))
+            ++it;
+        return it;
+    }
+
+    void cursor_buffer_release(void *data, struct wl_buffer *wl_buffer)
+    {
+        sf::Lock lock(mutex);
+        sf::priv::WaylandDisplay* display = static_cast<sf::priv::WaylandDisplay*>(data);
+        std::vector<sf::priv::WaylandCursorRange>::iterator it = find_cursor_range(display, wl_buffer);
+        if (it == display->cursor_ranges.end())
+            return;
+
+        it->busy = false;
+
+        // The cursor is gone and the compositor is done with the image: reuse its memory
+        if (it->destroyed) {
+            wl_buffer_destroy(wl_buffer);
+            display->cursor_ranges.erase(it);
+        }
+    }
+
+    static const struct wl_buffer_listener cursor_buffer_listener = {
+        cursor_buffer_release
+    };
 }
 
 namespace sf
@@ -407,35 +629,90 @@ namespace sf
 namespace priv
 {
 WaylandDisplay::WaylandDisplay() :
+    disconnected(false),
     registry(NULL),
     shm(NULL),
+    shm_xbgr8888(false),
     compositor(NULL),
+    compositor_version(0),
     data_device_manager(NULL),
     xdg_wm_base(NULL),
     relative_pointer_manager(NULL),
     pointer_constraints(NULL),
     decoration_manager(NULL),
+    presentation(NULL),
+    presentation_clock(CLOCK_MONOTONIC),
+    viewporter(NULL),
+    fractional_scale_manager(NULL),
+    tearing_control_manager(NULL),
     egl_dpy(EGL_NO_DISPLAY),
     seat(NULL),
-    output(NULL),
     window_list()
 {
 
-    output_width = 0;
-    output_height = 0;
-    output_scale = 1;
-
     std::fill(pointer_button_vector, pointer_button_vector+8, false);
     pointer_location_x = 0.;
     pointer_location_y = 0.;
 
     pointer = NULL;
+    relative_pointer = NULL;
     keyboard = NULL;
     keyboard_focus_window = NULL;
     pointer_focus_window = NULL;
     keyboard_keymap = NULL;
     keyboard_state = NULL;
+    // Defaults until the compositor sends repeat_info
+    keyboard_repeat_rate = 25;
+    keyboard_repeat_delay = 600;
+    keyboard_repeat_fd = -1;
+    keyboard_repeat_keycode = 0;
+    input_serial = 0;
+
+    cursor_pool = NULL;
+    cursor_pool_fd = -1;
+    cursor_pool_memory = NULL;
+    cursor_pool_size = 0;
+
+}
+
+////////////////////////////////////////////////////////////
+const WaylandOutputMode* WaylandOutput::getCurrentMode() const
+{
+    for (std::size_t i = 0; i < modes.size(); ++i)
+    {
+        if (modes[i].current)
+            return &modes[i];
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////
+int WaylandDisplay::getOutputScale(struct wl_output *output)
+{
+    Lock lock(mutex);
 
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        if (outputs[i]->output == output)
+            return outputs[i]->scale;
+    }
+    return 1;
+}
+
+////////////////////////////////////////////////////////////
+int WaylandDisplay::getOutputRefresh(struct wl_output *output)
+{
+    Lock lock(mutex);
+
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        if (outputs[i]->output != output)
+            continue;
+
+        const WaylandOutputMode* mode = outputs[i]->getCurrentMode();
+        return mode ? mode->refresh : 0;
+    }
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////
@@ -446,6 +723,7 @@ sf::priv::WaylandDisplay* OpenWaylandDisplay()
     if (referenceCount == 0)
     {
         shared_globals.display = wl_display_connect(NULL);
+        shared_globals.disconnected = false;
 
         // Opening display failed: The best we can do at the moment is to output a meaningful error message
         // and cause an abnormal program termination
@@ -454,9 +732,18 @@ sf::priv::WaylandDisplay* OpenWaylandDisplay()
             err() << "Failed to open Wayland display; make sure the WAYLAND_DISPLAY environment variable is set correctly" << std::endl;
             std::abort();
         }
+        shared_globals.keyboard_repeat_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (shared_globals.keyboard_repeat_fd < 0)
+        {
+            err() << "Failed to create the key repeat timer" << std::endl;
+            std::abort();
+        }
+
         shared_globals.registry = wl_display_get_registry(shared_globals.display);
         wl_registry_add_listener(shared_globals.registry, &registry_listener, NULL);
 
+        wl_display_roundtrip(shared_globals.display);
+        // Second roundtrip for the events of the newly bound globals (output modes, seat capabilities)
         wl_display_roundtrip(shared_globals.display);
 
         if (!shared_globals.shm) {
@@ -465,9 +752,6 @@ sf::priv::WaylandDisplay* OpenWaylandDisplay()
         } else if (!shared_globals.compositor) {
             err() << "Wayland compositor does not support wl_compositor" << std::endl;
             std::abort();
-        }else if (!shared_globals.data_device_manager) {
-            err() << "Wayland compositor does not support wl_data_device_manager" << std::endl;
-            std::abort();
         }else if (!shared_globals.xdg_wm_base) {
             err() << "Wayland compositor does not support xdg_wm_base" << std::endl;
             std::abort();
@@ -480,77 +764,257 @@ sf::priv::WaylandDisplay* OpenWaylandDisplay()
         }else if (!shared_globals.decoration_manager) {
             err() << "Wayland compositor does not support zxdg_decoration_manager_v1" << std::endl;
             std::abort();
-        }else if (!shared_globals.seat) {
-            err() << "Wayland compositor does have a seat" << std::endl;
-            std::abort();
-        }else if (!shared_globals.output) {
-            err() << "Wayland compositor does have an output" << std::endl;
-            std::abort();
         }
+        // Outputs are optional: they come and go with hotplug. Without a seat
+        // or a data device manager, there is no input and no clipboard
 
 
         shared_globals.keyboard_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
 
 
-        // TODO: find a decent source of documentation here
+        // EGL is only needed by OpenGL contexts: software presentation
+        // (and Vulkan) keep working without it
+        shared_globals.egl_dpy = OpenEglDisplay(shared_globals.display);
 
-        // or OPENGL_ES_API ?
-        if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE) {
-            err() << "We don't have EGL" << std::endl;
-            std::abort();
-        }
+        wl_display_flush(shared_globals.display); // voodoo, do we need it
+    }
+
+    referenceCount++;
+    return &shared_globals;
+}
 
-        //  TODO: INTEGRATE WITH ALL THE ACTUAL EGL STUFF
 
-        const char *extensions_list = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
-        bool has_ext_platform = false, has_khr_platform=false;
-        if (strstr(extensions_list, "EGL_EXT_platform_wayland")) {
-            has_ext_platform = true;
+////////////////////////////////////////////////////////////
+void CloseWaylandDisplay(sf::priv::WaylandDisplay* globals)
+{
+    Lock lock(mutex);
+
+    assert(globals == &shared_globals);
+
+    referenceCount--;
+    if (referenceCount == 0) {
+        // Input objects are created again by the next connection
+        release_pointer();
+        release_keyboard();
+        close(globals->keyboard_repeat_fd);
+        globals->keyboard_repeat_fd = -1;
+        for (std::size_t i = 0; i < globals->outputs.size(); ++i) {
+            wl_output_destroy(globals->outputs[i]->output);
+            delete globals->outputs[i];
         }
-        if (strstr(extensions_list, "EGL_KHR_platform_wayland")) {
-            has_khr_platform = true;
+        globals->outputs.clear();
+        for (std::size_t i = 0; i < globals->cursor_themes.size(); ++i) {
+            if (globals->cursor_themes[i].second)
+                wl_cursor_theme_destroy(globals->cursor_themes[i].second);
         }
-        if (!has_khr_platform && !has_ext_platform) {
-            err() << "EGL doesn't seem to support Wayland" << std::endl;
-            std::abort();
+        globals->cursor_themes.clear();
+        for (std::size_t i = 0; i < globals->cursor_ranges.size(); ++i) {
+            // Cursors destroyed while the compositor still used their image
+            if (globals->cursor_ranges[i].destroyed)
+                wl_buffer_destroy(globals->cursor_ranges[i].buffer);
+        }
+        globals->cursor_ranges.clear();
+        if (globals->cursor_pool) {
+            wl_shm_pool_destroy(globals->cursor_pool);
+            munmap(globals->cursor_pool_memory, globals->cursor_pool_size);
+            close(globals->cursor_pool_fd);
+            globals->cursor_pool = NULL;
+            globals->cursor_pool_fd = -1;
+            globals->cursor_pool_memory = NULL;
+            globals->cursor_pool_size = 0;
         }
-        // This is a space-separated list of extensions. To verify
+        if (globals->egl_dpy != EGL_NO_DISPLAY) {
+            eglTerminate(globals->egl_dpy);
+            globals->egl_dpy = EGL_NO_DISPLAY;
+        }
+        wl_display_disconnect(globals->display);
+    }
+}
 
 
+////////////////////////////////////////////////////////////
+std::vector<WaylandOutput> GetWaylandOutputs(WaylandDisplay* display)
+{
+    Lock lock(mutex);
 
-        shared_globals.egl_dpy = eglGetPlatformDisplay(has_ext_platform ? EGL_PLATFORM_WAYLAND_EXT :EGL_PLATFORM_WAYLAND_KHR, shared_globals.display, NULL);
-        if (shared_globals.egl_dpy == EGL_NO_DISPLAY) {
-            err() << "EGL could not make use of the display" << std::endl;
-            std::abort();
+    std::vector<WaylandOutput> outputs;
+    for (std::size_t i = 0; i < display->outputs.size(); ++i)
+        outputs.push_back(*display->outputs[i]);
+    return outputs;
+}
+
+
+////////////////////////////////////////////////////////////
+void ProcessWaylandKeyRepeat(WaylandDisplay* display)
+{
+    uint64_t expirations = 0;
+    if (read(display->keyboard_repeat_fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return;
+
+    uint32_t keycode = display->keyboard_repeat_keycode;
+    WindowImplWayland* window = display->keyboard_focus_window;
+    if (!window || !keycode || !display->keyboard_state)
+        return;
+
+    xkb_keysym_t keysym = xkb_state_key_get_one_sym(display->keyboard_state, keycode);
+    uint32_t unikey = xkb_state_key_get_utf32(display->keyboard_state, keycode);
+    xkb_mod_mask_t modmask = xkb_state_serialize_mods(display->keyboard_state, XKB_STATE_MODS_EFFECTIVE);
+
+    // Catch up with the repeats that were due while we weren't looking
+    for (uint64_t i = 0; i < expirations; ++i)
+        window->handleWaylandKeyboardRepeat(keysym, unikey,
+                                            modmask & (1<<1),
+                                            modmask & (1<<3),
+                                            modmask & (1<<4),
+                                            modmask & (1<<6));
+}
+
+
+////////////////////////////////////////////////////////////
+struct wl_cursor_theme* GetWaylandCursorTheme(WaylandDisplay* display, int scale)
+{
+    Lock lock(mutex);
+
+    for (std::size_t i = 0; i < display->cursor_themes.size(); ++i)
+    {
+        if (display->cursor_themes[i].first == scale)
+            return display->cursor_themes[i].second;
+    }
+
+    // Use the same theme and size as the other applications
+    const char* name = std::getenv("XCURSOR_THEME");
+    const char* sizeVariable = std::getenv("XCURSOR_SIZE");
+    int size = sizeVariable ? std::atoi(sizeVariable) : 0;
+    if (size <= 0)
+        size = 24;
+
+    struct wl_cursor_theme* theme = wl_cursor_theme_load(name, size * scale, display->shm);
+    if (!theme)
+        err() << "Failed to load the cursor theme" << std::endl;
+
+    // Failures are remembered as well, so that we don't retry on every cursor change
+    display->cursor_themes.push_back(std::make_pair(scale, theme));
+    return theme;
+}
+
+
+////////////////////////////////////////////////////////////
+struct wl_buffer* CreateWaylandCursorBuffer(WaylandDisplay* display, const Uint8* pixels, unsigned int width, unsigned int height)
+{
+    Lock lock(mutex);
+
+    std::size_t stride = width * 4;
+    std::size_t size = stride * height;
+
+    // Take the first gap between the images of the live cursors
+    std::size_t offset = 0;
+    std::vector<WaylandCursorRange>::iterator next = display->cursor_ranges.begin();
+    while ((next != display->cursor_ranges.end()) && (next->offset < offset + size))
+    {
+        offset = next->offset + next->size;
+        ++next;
+    }
+
+    if (offset + size > display->cursor_pool_size)
+    {
+        // Grow geometrically, so that loading many cursors doesn't remap the pool every time
+        std::size_t poolSize = std::max(display->cursor_pool_size * 2, offset + size);
+        poolSize = (poolSize + 65535) & ~static_cast<std::size_t>(65535);
+        poolSize = std::min(poolSize, max_cursor_pool_size);
+        if (offset + size > poolSize)
+        {
+            err() << "Failed to allocate the image of a cursor, too many cursors are loaded" << std::endl;
+            return NULL;
         }
 
-        int major_version = -1, minor_version = -1;
-        EGLBoolean ret = eglInitialize(shared_globals.egl_dpy, &major_version, &minor_version);
-        if (ret == EGL_FALSE) {
-            err() << "Failed to initialize EGL" << std::endl;
-            std::abort();
+        if (display->cursor_pool_fd < 0)
+        {
+            display->cursor_pool_fd = memfd_create("sfml-cursors", MFD_CLOEXEC);
+            if (display->cursor_pool_fd < 0)
+            {
+                err() << "Failed to create the shared memory for cursors" << std::endl;
+                return NULL;
+            }
         }
-        err() << major_version << "  " << minor_version<<std::endl;
 
-        wl_display_flush(shared_globals.display); // voodoo, do we need it
+        if (ftruncate(display->cursor_pool_fd, poolSize) < 0)
+        {
+            err() << "Failed to allocate the shared memory for cursors" << std::endl;
+            return NULL;
+        }
+
+        void* memory = mmap(NULL, poolSize, PROT_READ | PROT_WRITE, MAP_SHARED, display->cursor_pool_fd, 0);
+        if (memory == MAP_FAILED)
+        {
+            err() << "Failed to map the shared memory for cursors" << std::endl;
+            return NULL;
+        }
+
+        if (display->cursor_pool_memory)
+            munmap(display->cursor_pool_memory, display->cursor_pool_size);
+        display->cursor_pool_memory = static_cast<Uint8*>(memory);
+
+        if (display->cursor_pool)
+            wl_shm_pool_resize(display->cursor_pool, poolSize);
+        else
+            display->cursor_pool = wl_shm_create_pool(display->shm, display->cursor_pool_fd, poolSize);
+
+        display->cursor_pool_size = poolSize;
     }
 
-    referenceCount++;
-    return &shared_globals;
+    // Convert to premultiplied ARGB, the format every compositor supports
+    Uint8* target = display->cursor_pool_memory + offset;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; ++i)
+    {
+        Uint8 alpha = pixels[i * 4 + 3];
+        target[i * 4 + 0] = static_cast<Uint8>(pixels[i * 4 + 2] * alpha / 255);
+        target[i * 4 + 1] = static_cast<Uint8>(pixels[i * 4 + 1] * alpha / 255);
+        target[i * 4 + 2] = static_cast<Uint8>(pixels[i * 4 + 0] * alpha / 255);
+        target[i * 4 + 3] = alpha;
+    }
+
+    struct wl_buffer* buffer = wl_shm_pool_create_buffer(display->cursor_pool, offset,
+                                                         width, height, stride, WL_SHM_FORMAT_ARGB8888);
+    wl_buffer_add_listener(buffer, &cursor_buffer_listener, display);
+
+    WaylandCursorRange range;
+    range.offset    = offset;
+    range.size      = size;
+    range.buffer    = buffer;
+    range.busy      = false;
+    range.destroyed = false;
+    display->cursor_ranges.insert(next, range);
+    return buffer;
 }
 
 
 ////////////////////////////////////////////////////////////
-void CloseWaylandDisplay(sf::priv::WaylandDisplay* globals)
+void DestroyWaylandCursorBuffer(WaylandDisplay* display, struct wl_buffer* buffer)
 {
     Lock lock(mutex);
 
-    assert(globals == &shared_globals);
-
-    referenceCount--;
-    if (referenceCount == 0) {
-        wl_display_disconnect(globals->display);
+    std::vector<WaylandCursorRange>::iterator it = find_cursor_range(display, buffer);
+    if ((it != display->cursor_ranges.end()) && it->busy)
+    {
+        // The compositor may still read the image, wait for the release
+        it->destroyed = true;
+        return;
     }
+
+    wl_buffer_destroy(buffer);
+    if (it != display->cursor_ranges.end())
+        display->cursor_ranges.erase(it);
+}
+
+
+////////////////////////////////////////////////////////////
+void UseWaylandCursorBuffer(WaylandDisplay* display, struct wl_buffer* buffer)
+{
+    Lock lock(mutex);
+
+    std::vector<WaylandCursorRange>::iterator it = find_cursor_range(display, buffer);
+    if (it != display->cursor_ranges.end())
+        it->busy = true;
 }
 
 } // namespace priv
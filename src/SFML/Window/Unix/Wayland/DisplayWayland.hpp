@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <string>
+#include <ctime>
 
 #include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
@@ -36,8 +37,14 @@
 #include <relative-pointer-unstable-v1.h>
 #include <pointer-constraints-unstable-v1.h>
 #include <xdg-decoration-unstable-v1.h>
+#include <presentation-time.h>
+#include <viewporter.h>
+#include <fractional-scale-v1.h>
+#include <tearing-control-v1.h>
 
 #include <wayland-egl.h>
+#include <wayland-cursor.h>
+#include <SFML/Config.hpp>
 #include <vector>
 #include <xkbcommon/xkbcommon.h>
 
@@ -50,27 +57,67 @@ typedef void *EGLDisplay;
 typedef void *EGLConfig;
 typedef void *EGLSurface;
 typedef void *EGLContext;
+
+struct WaylandOutputMode {
+    int width, height; // in pixels
+    int refresh; // in mHz
+    bool current;
+};
+
+struct WaylandCursorRange {
+    std::size_t offset, size; // in bytes, in the cursor pool
+    struct wl_buffer *buffer;
+    bool busy; // attached since the last release, the compositor may read it
+    bool destroyed; // by its cursor, the range is freed on release
+};
+
+struct WaylandOutput {
+    uint32_t name; // registry name, to handle removal
+    struct wl_output *output;
+    int x, y; // in compositor space
+    int physical_width, physical_height; // in mm
+    int scale;
+    std::string make, model;
+    std::vector<WaylandOutputMode> modes;
+
+    const WaylandOutputMode* getCurrentMode() const;
+};
+
 class WaylandDisplay {
 public:
     WaylandDisplay();
+
+    // Scale of an output, 1 if it was removed (thread-safe)
+    int getOutputScale(struct wl_output *output);
+    // Refresh rate of the current mode of an output in mHz, 0 if unknown (thread-safe)
+    int getOutputRefresh(struct wl_output *output);
     // TODO: mutex protection for all this, because different windows may run
     // on different threads
     struct wl_display *display;
+    bool disconnected; // has the compositor hung up?
     struct wl_registry *registry;
     struct wl_shm *shm;
+    bool shm_xbgr8888; // can shm buffers hold RGBA bytes directly?
     struct wl_compositor *compositor;
+    uint32_t compositor_version;
     struct wl_data_device_manager *data_device_manager;
     struct xdg_wm_base *xdg_wm_base;
     struct zwp_relative_pointer_manager_v1 *relative_pointer_manager;
     struct zwp_pointer_constraints_v1 *pointer_constraints;
     struct zxdg_decoration_manager_v1 *decoration_manager;
+    struct wp_presentation *presentation; // optional
+    clockid_t presentation_clock;
+    struct wp_viewporter *viewporter; // optional
+    struct wp_fractional_scale_manager_v1 *fractional_scale_manager; // optional
+    struct wp_tearing_control_manager_v1 *tearing_control_manager; // optional
     EGLDisplay egl_dpy;
     struct xkb_context* keyboard_context;
 
     // TODO: make vectors of these!
-    // (And analogous classes WaylandSeat (incl seat,pointer,keyboard), WaylandOutput)
+    // (And analogous class WaylandSeat (incl seat,pointer,keyboard))
     struct wl_seat *seat;
     struct wl_pointer* pointer;
+    struct zwp_relative_pointer_v1* relative_pointer;
     struct wl_keyboard* keyboard;
     std::vector<std::pair<uint32_t, uint32_t>> keyboard_held_keys;
     WindowImplWayland * keyboard_focus_window;
@@ -79,9 +126,22 @@ public:
     float pointer_location_x, pointer_location_y;
     struct xkb_keymap* keyboard_keymap;
     struct xkb_state* keyboard_state;
+    int keyboard_repeat_rate; // in keys per second, 0 to disable
+    int keyboard_repeat_delay; // in ms
+    int keyboard_repeat_fd; // timerfd, armed while a key repeats
+    uint32_t keyboard_repeat_keycode;
+    uint32_t input_serial; // of the latest input event, to claim the selection
 
-    struct wl_output *output;
-    int output_width, output_height, output_scale;
+    std::vector<WaylandOutput*> outputs;
+
+    // Cursor themes, loaded once per scale (NULL when loading failed)
+    std::vector<std::pair<int, struct wl_cursor_theme*>> cursor_themes;
+    // Pool holding the images of all the custom cursors
+    struct wl_shm_pool *cursor_pool;
+    int cursor_pool_fd;
+    Uint8 *cursor_pool_memory;
+    std::size_t cursor_pool_size;
+    std::vector<WaylandCursorRange> cursor_ranges; // allocated parts of the pool, sorted by offset
 
 
     std::vector<WindowImplWayland *> window_list;
@@ -106,6 +166,87 @@ WaylandDisplay* OpenWaylandDisplay();
 ////////////////////////////////////////////////////////////
 void CloseWaylandDisplay(WaylandDisplay* display);
 
+////////////////////////////////////////////////////////////
+/// \brief Get a copy of the state of the outputs
+///
+/// The outputs are updated by whichever thread dispatches the
+/// events of the display: a copy taken under the display mutex
+/// can safely be read from any thread.
+///
+/// \param display Display owning the outputs
+///
+/// \return Copy of the outputs, as last described by the compositor
+///
+////////////////////////////////////////////////////////////
+std::vector<WaylandOutput> GetWaylandOutputs(WaylandDisplay* display);
+
+////////////////////////////////////////////////////////////
+/// \brief Generate the key repeats that are due
+///
+/// Key repeat is driven by the keyboard_repeat_fd timer of the
+/// display, which becomes readable when repeats are due. The
+/// repeated key presses are sent to the focused window.
+///
+/// \param display Display owning the timer
+///
+////////////////////////////////////////////////////////////
+void ProcessWaylandKeyRepeat(WaylandDisplay* display);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the cursor theme for a scale
+///
+/// The theme of the desktop (XCURSOR_THEME and XCURSOR_SIZE)
+/// is loaded on first use and shared by all the cursors.
+///
+/// \param display Display owning the themes
+/// \param scale   Integer scale of the cursor surface
+///
+/// \return Cursor theme, or NULL if it could not be loaded
+///
+////////////////////////////////////////////////////////////
+struct wl_cursor_theme* GetWaylandCursorTheme(WaylandDisplay* display, int scale);
+
+////////////////////////////////////////////////////////////
+/// \brief Upload a custom cursor image
+///
+/// The images of all the cursors share a single shm pool, so
+/// a cursor costs one upload when it is loaded and nothing
+/// when it is displayed. The parts of the pool are reused once
+/// their cursor is destroyed and the compositor released them;
+/// the pool doesn't grow beyond a fixed limit.
+///
+/// \param display Display owning the pool
+/// \param pixels  Array of pixels, in RGBA format
+/// \param width   Width of the image
+/// \param height  Height of the image
+///
+/// \return Buffer holding the image, or NULL on failure
+///
+////////////////////////////////////////////////////////////
+struct wl_buffer* CreateWaylandCursorBuffer(WaylandDisplay* display, const Uint8* pixels, unsigned int width, unsigned int height);
+
+////////////////////////////////////////////////////////////
+/// \brief Release a buffer created by CreateWaylandCursorBuffer
+///
+/// \param display Display owning the pool
+/// \param buffer  Buffer to destroy
+///
+////////////////////////////////////////////////////////////
+void DestroyWaylandCursorBuffer(WaylandDisplay* display, struct wl_buffer* buffer);
+
+////////////////////////////////////////////////////////////
+/// \brief Tell that a cursor buffer is about to be attached
+///
+/// Its part of the pool is kept until the compositor releases
+/// it, even if the cursor is destroyed in the meantime. Buffers
+/// not created by CreateWaylandCursorBuffer are ignored.
+///
+/// \param display Display owning the pool
+/// \param buffer  Buffer to attach
+///
+////////////////////////////////////////////////////////////
+void UseWaylandCursorBuffer(WaylandDisplay* display, struct wl_buffer* buffer);
+
 } // namespace priv
 
 } // namespace sf
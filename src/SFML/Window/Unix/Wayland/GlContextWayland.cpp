@@ -33,8 +33,15 @@
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
 //#include <SFML/Window/EGLCheck.hpp>
 #include <vector>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
 
 #if !defined(GLX_DEBUGGING) && defined(SFML_DEBUG)
     // Enable this to print messages to err() everytime GLX produces errors
@@ -46,46 +53,53 @@ namespace
     sf::Mutex glxErrorMutex;
     bool glxErrorOccurred = false;
 
+    bool hasExtension(EGLDisplay egl_dpy, const char* name) {
+        const char* extensions = eglQueryString(egl_dpy, EGL_EXTENSIONS);
+        return extensions && strstr(extensions, name);
+    }
 
-    EGLConfig chooseConfig (const sf::ContextSettings& settings, EGLDisplay egl_dpy, bool for_window ) {
-        // Create EGL context
-        EGLint num_configs = -1;
-        if (eglGetConfigs(egl_dpy, NULL, 0, &num_configs) == EGL_FALSE) {
-            sf::err() << "Failed to count configs" << std::endl;
-            std::abort();
-        }
-
-        EGLint conf_attr_list[11] = {
-            // cannot do both window&pbuffer, it seems
-            EGL_SURFACE_TYPE, for_window ? EGL_WINDOW_BIT : EGL_PBUFFER_BIT,
-    //        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
-            EGL_BLUE_SIZE, 1,
-           EGL_GREEN_SIZE, 1,
-           EGL_RED_SIZE, 1,
-            EGL_DEPTH_SIZE, std::min((EGLint)settings.depthBits, 16),
-            EGL_NONE};
-        EGLint num_matches = -1;
-        std::vector<EGLConfig> configs(num_configs);
-        if (eglChooseConfig(egl_dpy,conf_attr_list, configs.data(),num_configs,&num_matches) == EGL_FALSE) {
-            sf::err() << "Failed to get list of configs" << std::endl;
-            std::abort();
-        }
-
-        if (num_matches <= 0) {
-            sf::err() << "No matching configs" << std::endl;
-            std::abort();
+    // The KHR and EXT variants have the same signature
+    PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC getSwapBuffersWithDamage(EGLDisplay egl_dpy) {
+        static bool loaded = false;
+        static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC function = NULL;
+        if (!loaded) {
+            loaded = true;
+            if (hasExtension(egl_dpy, "EGL_KHR_swap_buffers_with_damage")) {
+                function = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+            } else if (hasExtension(egl_dpy, "EGL_EXT_swap_buffers_with_damage")) {
+                function = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+            }
         }
-        configs.resize(num_matches);
-        sf::err() << configs.size() << " matching configs" << std::endl;
-
-        for (EGLConfig c : configs) {
-            // TODO: use eglGetConfigAttrib to figure out all the properties
+        return function;
+    }
 
-            EGLint val;
-            EGLBoolean v = eglGetConfigAttrib(egl_dpy, c, EGL_DEPTH_SIZE, &val);
-//            sf::err() << val << " " << v << " " <<  c << std::endl;
-        }
-        return configs[0];
+    // Entry points of the image and sync extensions, resolved on first use
+    PFNEGLCREATEIMAGEKHRPROC              createImage         = NULL;
+    PFNEGLDESTROYIMAGEKHRPROC             destroyImage        = NULL;
+    PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC  queryDmaBufImage    = NULL;
+    PFNEGLEXPORTDMABUFIMAGEMESAPROC       exportDmaBufImage   = NULL;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC   imageTargetTexture  = NULL;
+    PFNEGLCREATESYNCKHRPROC               createSync          = NULL;
+    PFNEGLDESTROYSYNCKHRPROC              destroySync         = NULL;
+    PFNEGLCLIENTWAITSYNCKHRPROC           clientWaitSync      = NULL;
+    PFNEGLWAITSYNCKHRPROC                 waitSync            = NULL;
+    PFNEGLDUPNATIVEFENCEFDANDROIDPROC     dupNativeFence      = NULL;
+
+    void loadExtensionFunctions() {
+        static bool loaded = false;
+        if (loaded)
+            return;
+        loaded = true;
+        createImage        = (PFNEGLCREATEIMAGEKHRPROC)eglGetProcAddress("eglCreateImageKHR");
+        destroyImage       = (PFNEGLDESTROYIMAGEKHRPROC)eglGetProcAddress("eglDestroyImageKHR");
+        queryDmaBufImage   = (PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC)eglGetProcAddress("eglExportDMABUFImageQueryMESA");
+        exportDmaBufImage  = (PFNEGLEXPORTDMABUFIMAGEMESAPROC)eglGetProcAddress("eglExportDMABUFImageMESA");
+        imageTargetTexture = (PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)eglGetProcAddress("glEGLImageTargetTexture2DOES");
+        createSync         = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+        destroySync        = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+        clientWaitSync     = (PFNEGLCLIENTWAITSYNCKHRPROC)eglGetProcAddress("eglClientWaitSyncKHR");
+        waitSync           = (PFNEGLWAITSYNCKHRPROC)eglGetProcAddress("eglWaitSyncKHR");
+        dupNativeFence     = (PFNEGLDUPNATIVEFENCEFDANDROIDPROC)eglGetProcAddress("eglDupNativeFenceFDANDROID");
     }
 }
 
@@ -100,7 +114,9 @@ m_display   (NULL),
 m_surface(EGL_NO_SURFACE),
 m_context   (EGL_NO_CONTEXT),
 m_ctx_config   (NULL),
-m_ownsWindow(false)
+m_ownsWindow(false),
+m_window    (NULL),
+m_vsync     (false)
 {
     // Save the creation settings
     m_settings = ContextSettings();
@@ -108,22 +124,19 @@ m_ownsWindow(false)
     // Open the connection with the X server
     m_display = OpenWaylandDisplay();
 
-    err() << "Making a GlxContext context from nothing" << std::endl;
-    err() << "SKIPPING" << std::endl;
-    return;
-//    return; // cannot make pbuffer, it seems. Or can we?
-
+    // Nothing is ever rendered to the default framebuffer of this context:
+    // it only needs a surface if EGL can't make it current without one
+    bool surfaceless = hasExtension(m_display->egl_dpy, "EGL_KHR_surfaceless_context");
 
-    // Make sure that extensions are initialized
-//    ensureExtensionsInit(m_display, DefaultScreen(m_display));
-
-    m_ctx_config = chooseConfig(m_settings, m_display->egl_dpy, false);
+    m_ctx_config = selectBestConfig(m_display->egl_dpy, VideoMode::getDesktopMode().bitsPerPixel, m_settings, surfaceless ? 0 : EGL_PBUFFER_BIT);
+    updateSettingsFromConfig();
 
     // Create the context (and pick config, first)
     createContext(shared);
 
-    // Create the rendering surface (window or pbuffer if supported)
-    createSurface(shared, 1, 1, VideoMode::getDesktopMode().bitsPerPixel);
+    // Create the rendering surface (pbuffer if surfaceless contexts aren't supported)
+    if (!surfaceless)
+        createSurface(shared, 1, 1, VideoMode::getDesktopMode().bitsPerPixel);
 
 }
 
@@ -134,7 +147,9 @@ m_display   (NULL),
 m_surface (EGL_NO_SURFACE),
 m_context   (EGL_NO_CONTEXT),
 m_ctx_config   (NULL),
-m_ownsWindow(false)
+m_ownsWindow(false),
+m_window    (NULL),
+m_vsync     (false)
 {
     // Save the creation settings
     m_settings = settings;
@@ -145,15 +160,20 @@ m_ownsWindow(false)
 
     err() << "Calling GlxContext constructor from a window" << std::endl;
 
-    m_ctx_config = chooseConfig(m_settings, m_display->egl_dpy, true);
+    m_ctx_config = selectBestConfig(m_display->egl_dpy, bitsPerPixel, m_settings, EGL_WINDOW_BIT);
+    updateSettingsFromConfig();
 
     // Create context before creating window surface
     createContext(shared);
 
     err() << m_ctx_config << " " << m_context << std::endl;
 
-    WindowImplWayland* window = (WindowImplWayland*)owner;
-    createSurface(window->m_egl_window);
+    m_window = (WindowImplWayland*)owner;
+    createSurface(m_window->m_egl_window);
+
+    // From now on, the EGL window is only resized by the thread presenting frames
+    m_window->resizeEglWindow();
+
 //   makeCurrent(true);
 
 //   eglMakeCurrent(window->m_display, window->m_display)
@@ -179,7 +199,9 @@ m_display   (NULL),
 m_surface (EGL_NO_SURFACE),
 m_context   (EGL_NO_CONTEXT),
 m_ctx_config   (NULL),
-m_ownsWindow(false)
+m_ownsWindow(false),
+m_window    (NULL),
+m_vsync     (false)
 {
     // Save the creation settings
     m_settings = settings;
@@ -187,18 +209,19 @@ m_ownsWindow(false)
     // Open the connection with the X server
     m_display = OpenWaylandDisplay();
 
-    err() << "Calling GlxContext constructor from width/height pair" << std::endl;
-
-    // Make sure that extensions are initialized
-//    ensureExtensionsInit(m_display, DefaultScreen(m_display));
+    // The shared context (the one without a partner) only holds resources; the
+    // others may render to their default framebuffer (RenderTextureImplDefault)
+    bool surfaceless = !shared && hasExtension(m_display->egl_dpy, "EGL_KHR_surfaceless_context");
 
-    m_ctx_config = chooseConfig(m_settings, m_display->egl_dpy, false);
+    m_ctx_config = selectBestConfig(m_display->egl_dpy, VideoMode::getDesktopMode().bitsPerPixel, m_settings, surfaceless ? 0 : EGL_PBUFFER_BIT);
+    updateSettingsFromConfig();
 
     // Create the context
     createContext(shared);
 
-    // Create the rendering surface (window or pbuffer if supported)
-    createSurface(shared, width, height, VideoMode::getDesktopMode().bitsPerPixel);
+    // Create the rendering surface (pbuffer, unless surfaceless)
+    if (!surfaceless)
+        createSurface(shared, width, height, VideoMode::getDesktopMode().bitsPerPixel);
 
 }
 
@@ -209,6 +232,15 @@ GlContextWayland::~GlContextWayland()
     // Notify unshared OpenGL resources of context destruction
     cleanupUnsharedResources();
 
+    // Destroy the context and its surface, if any
+    if (m_context != EGL_NO_CONTEXT)
+    {
+        if (eglGetCurrentContext() == m_context)
+            eglMakeCurrent(m_display->egl_dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_display->egl_dpy, m_context);
+    }
+    if (m_surface != EGL_NO_SURFACE)
+        eglDestroySurface(m_display->egl_dpy, m_surface);
 
     // Close the connection with the X server
     CloseWaylandDisplay(m_display);
@@ -260,10 +292,38 @@ void GlContextWayland::display()
 #endif
 
     if (m_surface) {
-        if (eglSwapBuffers(m_display->egl_dpy, m_surface) == EGL_FALSE) {
+        if (m_window) {
+            // Throttle to the compositor's pace rather than EGL's
+            if (m_vsync)
+                m_window->waitForFrame();
+
+            // The frame callback and the surface state matching the
+            // buffer are committed along with it
+            m_window->requestFrame();
+            m_window->prepareCommit(m_window->m_egl_size);
+            m_window->takeDamage(m_damage);
+        }
+
+        EGLBoolean swapped;
+        PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swapBuffersWithDamage = getSwapBuffersWithDamage(m_display->egl_dpy);
+        if (swapBuffersWithDamage && !m_damage.empty()) {
+            // EGL rectangles start from the bottom of the surface
+            int height = m_window->m_egl_size.y;
+            for (std::size_t i = 0; i < m_damage.size(); i += 4)
+                m_damage[i + 1] = height - m_damage[i + 1] - m_damage[i + 3];
+            swapped = swapBuffersWithDamage(m_display->egl_dpy, m_surface, &m_damage[0], m_damage.size() / 4);
+        } else {
+            swapped = eglSwapBuffers(m_display->egl_dpy, m_surface);
+        }
+
+        if (swapped == EGL_FALSE) {
             err() << "Swap buffers failed" << std::endl;
             std::abort();
         }
+
+        // Resize between frames, never while one is being drawn
+        if (m_window)
+            m_window->resizeEglWindow();
     }
 
 #if defined(GLX_DEBUGGING)
@@ -276,10 +336,16 @@ void GlContextWayland::display()
 ////////////////////////////////////////////////////////////
 void GlContextWayland::setVerticalSyncEnabled(bool enabled)
 {
-    int result = 0;
-
-    if (result != 0)
+    // Never let eglSwapBuffers block on its own frame callbacks;
+    // display() does the throttling itself when v-sync is enabled
+    if (eglSwapInterval(m_display->egl_dpy, 0) == EGL_FALSE)
         err() << "Setting vertical sync failed" << std::endl;
+
+    m_vsync = enabled;
+
+    // Tearing is only allowed when frames aren't synchronized anyway
+    if (m_window)
+        m_window->setVerticalSyncHint(enabled);
 }
 
 
@@ -291,8 +357,13 @@ void GlContextWayland::createSurface(GlContextWayland* shared, unsigned int widt
     EGLint attrib_list[9] = {
         EGL_WIDTH, (EGLint)width,
         EGL_HEIGHT, (EGLint)height,
+        EGL_NONE, EGL_NONE,
         EGL_NONE
     };
+    if (m_settings.sRgbCapable) {
+        attrib_list[4] = EGL_GL_COLORSPACE_KHR;
+        attrib_list[5] = EGL_GL_COLORSPACE_SRGB_KHR;
+    }
 
     m_surface = eglCreatePbufferSurface(m_display->egl_dpy, m_ctx_config, attrib_list);
     if (m_surface == EGL_FALSE) {
@@ -308,7 +379,11 @@ void GlContextWayland::createSurface(struct wl_egl_window* window)
     // A window already exists, so just use it
     err() << "Calling createSurface(window)" << std::endl;
 
-    EGLAttrib attrib_list[1] = {EGL_NONE};
+    EGLAttrib attrib_list[3] = {EGL_NONE, EGL_NONE, EGL_NONE};
+    if (m_settings.sRgbCapable) {
+        attrib_list[0] = EGL_GL_COLORSPACE_KHR;
+        attrib_list[1] = EGL_GL_COLORSPACE_SRGB_KHR;
+    }
     m_surface = eglCreatePlatformWindowSurface(m_display->egl_dpy,
                                               m_ctx_config,
                                               window,
@@ -324,15 +399,381 @@ void GlContextWayland::createSurface(struct wl_egl_window* window)
 }
 
 
+////////////////////////////////////////////////////////////
+bool GlContextWayland::exportDmaBuf(unsigned int texture, DmaBuf& buffer)
+{
+    EGLDisplay display = m_display->egl_dpy;
+    if (!hasExtension(display, "EGL_KHR_gl_texture_2D_image") || !hasExtension(display, "EGL_MESA_image_dma_buf_export"))
+    {
+        err() << "Failed to export texture: EGL_MESA_image_dma_buf_export is not supported" << std::endl;
+        return false;
+    }
+
+    loadExtensionFunctions();
+    if (!createImage || !destroyImage || !queryDmaBufImage || !exportDmaBufImage)
+        return false;
+
+    // The image shares the storage of the texture, and the exported
+    // files keep it alive: the image itself isn't needed afterwards
+    EGLImageKHR image = createImage(display, m_context, EGL_GL_TEXTURE_2D_KHR, (EGLClientBuffer)(std::size_t)texture, NULL);
+    if (image == EGL_NO_IMAGE_KHR)
+    {
+        err() << "Failed to create an EGL image from the texture: " << std::hex << eglGetError() << std::endl;
+        return false;
+    }
+
+    int format = 0;
+    int planeCount = 0;
+    EGLuint64KHR modifier = 0x00ffffffffffffffULL;
+    EGLint fds[4] = {-1, -1, -1, -1};
+    EGLint strides[4] = {0, 0, 0, 0};
+    EGLint offsets[4] = {0, 0, 0, 0};
+    bool exported = (queryDmaBufImage(display, image, &format, &planeCount, &modifier) == EGL_TRUE) &&
+                    (planeCount > 0) && (planeCount <= 4) &&
+                    (exportDmaBufImage(display, image, fds, strides, offsets) == EGL_TRUE);
+    destroyImage(display, image);
+
+    if (!exported)
+    {
+        err() << "Failed to export the EGL image as a DMA buffer: " << std::hex << eglGetError() << std::endl;
+        return false;
+    }
+
+    buffer.format = static_cast<Uint32>(format);
+    buffer.modifier = modifier;
+    buffer.planeCount = static_cast<unsigned int>(planeCount);
+    for (int i = 0; i < 4; ++i)
+    {
+        buffer.fds[i] = fds[i];
+        buffer.strides[i] = static_cast<Uint32>(strides[i]);
+        buffer.offsets[i] = static_cast<Uint32>(offsets[i]);
+    }
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContextWayland::importDmaBuf(const DmaBuf& buffer)
+{
+    EGLDisplay display = m_display->egl_dpy;
+    if (!hasExtension(display, "EGL_EXT_image_dma_buf_import"))
+    {
+        err() << "Failed to import DMA buffer: EGL_EXT_image_dma_buf_import is not supported" << std::endl;
+        return false;
+    }
+
+    loadExtensionFunctions();
+    if (!createImage || !destroyImage || (buffer.planeCount == 0) || (buffer.planeCount > 4))
+        return false;
+
+    static const EGLint fdAttributes[4]       = {EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE3_FD_EXT};
+    static const EGLint offsetAttributes[4]   = {EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE3_OFFSET_EXT};
+    static const EGLint pitchAttributes[4]    = {EGL_DMA_BUF_PLANE0_PITCH_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT, EGL_DMA_BUF_PLANE3_PITCH_EXT};
+    static const EGLint modifierLoAttributes[4] = {EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE3_MODIFIER_LO_EXT};
+    static const EGLint modifierHiAttributes[4] = {EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT, EGL_DMA_BUF_PLANE3_MODIFIER_HI_EXT};
+
+    // Without explicit modifiers, the driver guesses the layout (DRM_FORMAT_MOD_INVALID)
+    bool explicitModifier = (buffer.modifier != 0x00ffffffffffffffULL) && hasExtension(display, "EGL_EXT_image_dma_buf_import_modifiers");
+
+    std::vector<EGLint> attributes;
+    attributes.push_back(EGL_WIDTH);
+    attributes.push_back(static_cast<EGLint>(buffer.width));
+    attributes.push_back(EGL_HEIGHT);
+    attributes.push_back(static_cast<EGLint>(buffer.height));
+    attributes.push_back(EGL_LINUX_DRM_FOURCC_EXT);
+    attributes.push_back(static_cast<EGLint>(buffer.format));
+    for (unsigned int i = 0; i < buffer.planeCount; ++i)
+    {
+        attributes.push_back(fdAttributes[i]);
+        attributes.push_back(buffer.fds[i]);
+        attributes.push_back(offsetAttributes[i]);
+        attributes.push_back(static_cast<EGLint>(buffer.offsets[i]));
+        attributes.push_back(pitchAttributes[i]);
+        attributes.push_back(static_cast<EGLint>(buffer.strides[i]));
+        if (explicitModifier)
+        {
+            attributes.push_back(modifierLoAttributes[i]);
+            attributes.push_back(static_cast<EGLint>(buffer.modifier & 0xffffffff));
+            attributes.push_back(modifierHiAttributes[i]);
+            attributes.push_back(static_cast<EGLint>(buffer.modifier >> 32));
+        }
+    }
+    attributes.push_back(EGL_NONE);
+
+    // EGL duplicates the file descriptors, they still belong to the caller
+    EGLImageKHR image = createImage(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, NULL, &attributes[0]);
+    if (image == EGL_NO_IMAGE_KHR)
+    {
+        err() << "Failed to create an EGL image from the DMA buffer: " << std::hex << eglGetError() << std::endl;
+        return false;
+    }
+
+    // The texture keeps the storage alive once the image is attached
+    bool imported = importImage(image);
+    destroyImage(display, image);
+    return imported;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContextWayland::importImage(void* image)
+{
+    loadExtensionFunctions();
+    if (!imageTargetTexture)
+    {
+        err() << "Failed to import EGL image: GL_OES_EGL_image is not supported" << std::endl;
+        return false;
+    }
+
+    // Clear previous errors, so that the result only reflects this call.
+    // Bounded: without a current context, glGetError may never return GL_NO_ERROR
+    for (int i = 0; (i < 8) && (glGetError() != GL_NO_ERROR); ++i)
+        ;
+
+    imageTargetTexture(GL_TEXTURE_2D, static_cast<GLeglImageOES>(image));
+    return glGetError() == GL_NO_ERROR;
+}
+
+
+////////////////////////////////////////////////////////////
+int GlContextWayland::insertFence()
+{
+    EGLDisplay display = m_display->egl_dpy;
+    loadExtensionFunctions();
+    if (!hasExtension(display, "EGL_ANDROID_native_fence_sync") || !createSync || !destroySync || !clientWaitSync || !dupNativeFence)
+        return -1;
+
+    EGLSyncKHR sync = createSync(display, EGL_SYNC_NATIVE_FENCE_ANDROID, NULL);
+    if (sync == EGL_NO_SYNC_KHR)
+        return -1;
+
+    // The file descriptor only exists once the fence is flushed to the GPU
+    clientWaitSync(display, sync, EGL_SYNC_FLUSH_COMMANDS_BIT_KHR, 0);
+    int fence = dupNativeFence(display, sync);
+    destroySync(display, sync);
+
+    return (fence == EGL_NO_NATIVE_FENCE_FD_ANDROID) ? -1 : fence;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GlContextWayland::waitForFence(int fence)
+{
+    if (fence < 0)
+        return false;
+
+    EGLDisplay display = m_display->egl_dpy;
+    loadExtensionFunctions();
+    if (hasExtension(display, "EGL_ANDROID_native_fence_sync") && hasExtension(display, "EGL_KHR_wait_sync") &&
+        createSync && destroySync && waitSync)
+    {
+        // EGL takes ownership of the file descriptor on success
+        EGLint attributes[] = {EGL_SYNC_NATIVE_FENCE_FD_ANDROID, fence, EGL_NONE};
+        EGLSyncKHR sync = createSync(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attributes);
+        if (sync != EGL_NO_SYNC_KHR)
+        {
+            bool waited = (waitSync(display, sync, 0) == EGL_TRUE);
+            destroySync(display, sync);
+            return waited;
+        }
+    }
+
+    // Fall back to waiting on the CPU: the sync file becomes readable once signaled
+    pollfd descriptor;
+    descriptor.fd = fence;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    while ((poll(&descriptor, 1, -1) < 0) && (errno == EINTR))
+        ;
+    close(fence);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+EGLConfig GlContextWayland::selectBestConfig(EGLDisplay display, unsigned int bitsPerPixel, const ContextSettings& settings, int surfaceType)
+{
+    // The display connection works without EGL, but OpenGL doesn't
+    if (display == EGL_NO_DISPLAY)
+    {
+        err() << "Failed to create an OpenGL context: EGL is not available on this display" << std::endl;
+        std::abort();
+    }
+
+    // Retrieve all the configs
+    EGLint count = 0;
+    if ((eglGetConfigs(display, NULL, 0, &count) == EGL_FALSE) || (count <= 0))
+    {
+        err() << "No EGL config found. You should check your graphics driver" << std::endl;
+        std::abort();
+    }
+    std::vector<EGLConfig> configs(count);
+    eglGetConfigs(display, &configs[0], count, &count);
+
+    // sRGB is a property of the surfaces rather than of the configs
+    bool sRgb = hasExtension(display, "EGL_KHR_gl_colorspace");
+
+    // Evaluate all the returned configs, and pick the best one
+    int bestScore = 0x7FFFFFFF;
+    EGLConfig bestConfig = NULL;
+    for (EGLint i = 0; i < count; ++i)
+    {
+        // Check mandatory attributes
+        EGLint surfaces, renderable, colorType;
+        eglGetConfigAttrib(display, configs[i], EGL_SURFACE_TYPE,     &surfaces);
+        eglGetConfigAttrib(display, configs[i], EGL_RENDERABLE_TYPE,  &renderable);
+        eglGetConfigAttrib(display, configs[i], EGL_COLOR_BUFFER_TYPE, &colorType);
+        if (((surfaces & surfaceType) != surfaceType) || !(renderable & EGL_OPENGL_BIT) || (colorType != EGL_RGB_BUFFER))
+            continue;
+
+        // Extract the components of the current config
+        EGLint red, green, blue, alpha, depth, stencil, multiSampling, samples, caveat;
+        eglGetConfigAttrib(display, configs[i], EGL_RED_SIZE,       &red);
+        eglGetConfigAttrib(display, configs[i], EGL_GREEN_SIZE,     &green);
+        eglGetConfigAttrib(display, configs[i], EGL_BLUE_SIZE,      &blue);
+        eglGetConfigAttrib(display, configs[i], EGL_ALPHA_SIZE,     &alpha);
+        eglGetConfigAttrib(display, configs[i], EGL_DEPTH_SIZE,     &depth);
+        eglGetConfigAttrib(display, configs[i], EGL_STENCIL_SIZE,   &stencil);
+        eglGetConfigAttrib(display, configs[i], EGL_SAMPLE_BUFFERS, &multiSampling);
+        eglGetConfigAttrib(display, configs[i], EGL_SAMPLES,        &samples);
+        eglGetConfigAttrib(display, configs[i], EGL_CONFIG_CAVEAT,  &caveat);
+
+        // Evaluate the config
+        int score;
+        if (surfaceType & EGL_WINDOW_BIT)
+        {
+            // Windows are opaque, the alpha channel of an XRGB buffer is
+            // mere padding: compare the visible bits only, and prefer
+            // configs without alpha at equal depth
+            unsigned int visibleBits = (bitsPerPixel == 32) ? 24 : bitsPerPixel;
+            score = evaluateFormat(visibleBits, settings, red + green + blue, depth, stencil, multiSampling ? samples : 0, caveat != EGL_SLOW_CONFIG, sRgb);
+            if (alpha > 0)
+                score += 1;
+        }
+        else
+        {
+            int color = red + green + blue + alpha;
+            score = evaluateFormat(bitsPerPixel, settings, color, depth, stencil, multiSampling ? samples : 0, caveat != EGL_SLOW_CONFIG, sRgb);
+        }
+
+        // If it's better than the current best, make it the new best
+        if (score < bestScore)
+        {
+            bestScore = score;
+            bestConfig = configs[i];
+        }
+    }
+
+    if (!bestConfig)
+    {
+        err() << "No EGL config supports OpenGL rendering. You should check your graphics driver" << std::endl;
+        std::abort();
+    }
+
+    return bestConfig;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlContextWayland::updateSettingsFromConfig()
+{
+    // Update the creation settings from the chosen config
+    EGLint depth, stencil, multiSampling, samples;
+    eglGetConfigAttrib(m_display->egl_dpy, m_ctx_config, EGL_DEPTH_SIZE,     &depth);
+    eglGetConfigAttrib(m_display->egl_dpy, m_ctx_config, EGL_STENCIL_SIZE,   &stencil);
+    eglGetConfigAttrib(m_display->egl_dpy, m_ctx_config, EGL_SAMPLE_BUFFERS, &multiSampling);
+    eglGetConfigAttrib(m_display->egl_dpy, m_ctx_config, EGL_SAMPLES,        &samples);
+
+    m_settings.depthBits         = static_cast<unsigned int>(depth);
+    m_settings.stencilBits       = static_cast<unsigned int>(stencil);
+    m_settings.antialiasingLevel = multiSampling ? samples : 0;
+    m_settings.sRgbCapable       = m_settings.sRgbCapable && hasExtension(m_display->egl_dpy, "EGL_KHR_gl_colorspace");
+}
+
+
 ////////////////////////////////////////////////////////////
 void GlContextWayland::createContext(GlContextWayland* shared)
 {
-    EGLint attrlist[5]= {
-//        EGL_CONTEXT_CLIENT_VERSION,3,
-        EGL_NONE};
-    m_context = eglCreateContext(m_display->egl_dpy, m_ctx_config,
-            shared ? shared->m_context : EGL_NO_CONTEXT, attrlist);
-    if (m_context == EGL_NO_CONTEXT) {
+    // Get a working copy of the context settings
+    ContextSettings settings = m_settings;
+
+    // Get the context to share display lists with
+    EGLContext sharedContext = shared ? shared->m_context : EGL_NO_CONTEXT;
+
+    // Create the OpenGL context -- first try requesting the version, profile and flags
+    bool createContextSupported = hasExtension(m_display->egl_dpy, "EGL_KHR_create_context");
+    while ((m_context == EGL_NO_CONTEXT) && createContextSupported && m_settings.majorVersion)
+    {
+        std::vector<EGLint> attributes;
+
+        // Check if the user requested a specific context version (anything > 1.1)
+        if ((m_settings.majorVersion > 1) || ((m_settings.majorVersion == 1) && (m_settings.minorVersion > 1)))
+        {
+            attributes.push_back(EGL_CONTEXT_MAJOR_VERSION_KHR);
+            attributes.push_back(static_cast<EGLint>(m_settings.majorVersion));
+            attributes.push_back(EGL_CONTEXT_MINOR_VERSION_KHR);
+            attributes.push_back(static_cast<EGLint>(m_settings.minorVersion));
+        }
+
+        // The profile is ignored by EGL for versions older than 3.2
+        EGLint profile = (m_settings.attributeFlags & ContextSettings::Core) ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR;
+        EGLint debug = (m_settings.attributeFlags & ContextSettings::Debug) ? EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR : 0;
+
+        attributes.push_back(EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR);
+        attributes.push_back(profile);
+        attributes.push_back(EGL_CONTEXT_FLAGS_KHR);
+        attributes.push_back(debug);
+
+        // Append the terminating attribute
+        attributes.push_back(EGL_NONE);
+
+        m_context = eglCreateContext(m_display->egl_dpy, m_ctx_config, sharedContext, &attributes[0]);
+
+        // If we couldn't create the context, first try disabling flags,
+        // then lower the version number and try again -- stop at 0.0
+        // Invalid version numbers will be generated by this algorithm (like 3.9), but we really don't care
+        if (m_context == EGL_NO_CONTEXT)
+        {
+            if (m_settings.attributeFlags != ContextSettings::Default)
+            {
+                m_settings.attributeFlags = ContextSettings::Default;
+            }
+            else if (m_settings.minorVersion > 0)
+            {
+                // If the minor version is not 0, we decrease it and try again
+                m_settings.minorVersion--;
+
+                m_settings.attributeFlags = settings.attributeFlags;
+            }
+            else
+            {
+                // If the minor version is 0, we decrease the major version
+                m_settings.majorVersion--;
+                m_settings.minorVersion = 9;
+
+                m_settings.attributeFlags = settings.attributeFlags;
+            }
+        }
+    }
+
+    // If EGL_KHR_create_context is not supported or failed, create a default context
+    if (m_context == EGL_NO_CONTEXT)
+    {
+        if (createContextSupported || (settings.attributeFlags != ContextSettings::Default))
+            err() << "Failed to create an OpenGL context with the requested settings, "
+                  << "falling back to the default context" << std::endl;
+
+        // set the context version to 1.1 (arbitrary) and disable flags
+        m_settings.majorVersion = 1;
+        m_settings.minorVersion = 1;
+        m_settings.attributeFlags = ContextSettings::Default;
+
+        EGLint attributes[] = {EGL_NONE};
+        m_context = eglCreateContext(m_display->egl_dpy, m_ctx_config, sharedContext, attributes);
+    }
+
+    if (m_context == EGL_NO_CONTEXT)
+    {
         err() << "Failed to make an EGL context" << std::endl;
         std::abort();
     }
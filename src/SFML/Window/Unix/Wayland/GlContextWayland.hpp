@@ -31,6 +31,7 @@
 #include <SFML/Window/GlContext.hpp>
 //#include <glad/glx.h>
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
+#include <vector>
 
 
 namespace sf
@@ -48,6 +49,9 @@ public:
     ////////////////////////////////////////////////////////////
     /// \brief Create a new default context
     ///
+    /// The context has no surface if EGL_KHR_surfaceless_context
+    /// is supported, and a 1x1 pbuffer otherwise.
+    ///
     /// \param shared Context to share the new one with (can be NULL)
     ///
     ////////////////////////////////////////////////////////////
@@ -115,32 +119,94 @@ public:
     /// This can avoid some visual artifacts, and limit the framerate
     /// to a good value (but not constant across different computers).
     ///
+    /// On Wayland, EGL never blocks by itself (swap interval 0);
+    /// instead display() waits for the frame callback of the
+    /// previous frame, so hidden windows stop rendering.
+    ///
     /// \param enabled True to enable v-sync, false to deactivate
     ///
     ////////////////////////////////////////////////////////////
     virtual void setVerticalSyncEnabled(bool enabled);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Select the best GLX visual for a given set of settings
+    /// \brief Export a texture as a DMA buffer
+    ///
+    /// Uses an EGLImage of the texture, exported with
+    /// EGL_MESA_image_dma_buf_export.
+    ///
+    /// \param texture OpenGL name of the texture to export
+    /// \param buffer  Filled with the description of the DMA buffer
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool exportDmaBuf(unsigned int texture, DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use a DMA buffer as the storage of the bound texture
+    ///
+    /// Uses an EGLImage created with EGL_EXT_image_dma_buf_import.
+    ///
+    /// \param buffer Description of the DMA buffer to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importDmaBuf(const DmaBuf& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Use an EGL image as the storage of the bound texture
+    ///
+    /// \param image EGLImage to import
+    ///
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool importImage(void* image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a fence after the commands issued so far
+    ///
+    /// Uses EGL_ANDROID_native_fence_sync.
+    ///
+    /// \return File descriptor of the fence, -1 on failure
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual int insertFence();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a fence before executing the next commands
+    ///
+    /// The GPU waits if EGL_KHR_wait_sync is supported, the CPU
+    /// otherwise.
+    ///
+    /// \param fence File descriptor of the fence, owned by the function
     ///
-    /// \param display      X display
+    /// \return True on success, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool waitForFence(int fence);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Select the best EGL config for a given set of settings
+    ///
+    /// \param display      EGL display
     /// \param bitsPerPixel Pixel depth, in bits per pixel
     /// \param settings     Requested context settings
+    /// \param surfaceType  Kinds of surface the config must support (EGL_WINDOW_BIT, ..., 0 for surfaceless)
     ///
-    /// \return The best visual
+    /// \return The best config
     ///
     ////////////////////////////////////////////////////////////
-//    static XVisualInfo selectBestVisual(::Display* display, unsigned int bitsPerPixel, const ContextSettings& settings);
+    static EGLConfig selectBestConfig(EGLDisplay display, unsigned int bitsPerPixel, const ContextSettings& settings, int surfaceType);
 
 private:
 
     ////////////////////////////////////////////////////////////
-    /// \brief Update the context visual settings from XVisualInfo
-    ///
-    /// \param visualInfo XVisualInfo to update settings from
+    /// \brief Update the context visual settings from the chosen EGL config
     ///
     ////////////////////////////////////////////////////////////
-//    void updateSettingsFromVisualInfo(XVisualInfo* visualInfo);
+    void updateSettingsFromConfig();
 
     ////////////////////////////////////////////////////////////
     /// \brief Update the context visual settings from the window
@@ -183,6 +249,9 @@ private:
     EGLContext        m_context;    ///< OpenGL context
     EGLConfig         m_ctx_config; ///< Config associated with context
     bool              m_ownsWindow; ///< Do we own the window associated to the context?
+    WindowImplWayland* m_window;    ///< Window we render to, if any
+    bool              m_vsync;      ///< Do we wait for the compositor's frame callbacks?
+    std::vector<int>  m_damage;     ///< Damage of the frame being presented, reused to avoid allocations
 };
 
 } // namespace priv
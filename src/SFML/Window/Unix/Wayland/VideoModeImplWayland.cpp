@@ -40,8 +40,28 @@ std::vector<VideoMode> VideoModeImplWayland::getFullscreenModes()
 {
     std::vector<VideoMode> modes;
 
-    // TODO: use xdg_output to get display size!
-    modes.push_back(VideoMode(1024, 768));
+    // Fullscreen windows can be shown on any output
+    WaylandDisplay* display = OpenWaylandDisplay();
+    std::vector<WaylandOutput> outputs = GetWaylandOutputs(display);
+    CloseWaylandDisplay(display);
+
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        const std::vector<WaylandOutputMode>& outputModes = outputs[i].modes;
+        for (std::size_t j = 0; j < outputModes.size(); ++j)
+        {
+            VideoMode mode(outputModes[j].width, outputModes[j].height);
+
+            // Add it only if it is not already in the array
+            if (std::find(modes.begin(), modes.end(), mode) == modes.end())
+                modes.push_back(mode);
+        }
+    }
+
+    // Fallback, in case no mode was provided
+    if (modes.empty())
+        modes.push_back(getDesktopMode());
+
     return modes;
 }
 
@@ -51,19 +71,69 @@ VideoMode VideoModeImplWayland::getDesktopMode()
 {
     VideoMode desktopMode;
     WaylandDisplay* display = OpenWaylandDisplay();
-    if (display->output_width > 0 && display->output_height > 0) {
-        // TODO: actually check this. Also, what if there are multiple outputs?
-        desktopMode = VideoMode(display->output_width / display->output_scale,
-                                display->output_height / display->output_scale);
+    std::vector<WaylandOutput> outputs = GetWaylandOutputs(display);
+    CloseWaylandDisplay(display);
+
+    const WaylandOutputMode* mode = outputs.empty() ? NULL : outputs[0].getCurrentMode();
+    if (mode && mode->width > 0 && mode->height > 0) {
+        // The desktop is described by the first output, in compositor units
+        desktopMode = VideoMode(mode->width / outputs[0].scale,
+                                mode->height / outputs[0].scale);
     } else {
         // Fallback, in case mode not provided
         desktopMode = VideoMode(800, 600);
     }
 
-    CloseWaylandDisplay(display);
     return desktopMode;
 }
 
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImplWayland::getMonitors()
+{
+    std::vector<Monitor> monitors;
+
+    // Hotplugged outputs are picked up while the windows process their events
+    // (or by the connection itself, if no window is open): reading the display
+    // from here would steal the events of the thread dispatching them
+    WaylandDisplay* display = OpenWaylandDisplay();
+    std::vector<WaylandOutput> outputs = GetWaylandOutputs(display);
+    CloseWaylandDisplay(display);
+
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        const WaylandOutput& output = outputs[i];
+
+        Monitor monitor;
+        monitor.name = output.make + " " + output.model;
+        monitor.position = Vector2i(output.x, output.y);
+        monitor.physicalSize = Vector2u(output.physical_width, output.physical_height);
+        monitor.scale = output.scale;
+
+        // VideoMode has no refresh rate: modes differing only by their rate are the same
+        for (std::size_t j = 0; j < output.modes.size(); ++j)
+        {
+            VideoMode mode(output.modes[j].width, output.modes[j].height);
+            if (std::find(monitor.modes.begin(), monitor.modes.end(), mode) == monitor.modes.end())
+                monitor.modes.push_back(mode);
+        }
+
+        const WaylandOutputMode* mode = output.getCurrentMode();
+        if (mode)
+        {
+            monitor.desktopMode = VideoMode(mode->width, mode->height);
+            monitor.refreshRate = mode->refresh / 1000.f;
+            if (output.physical_width > 0 && output.physical_height > 0)
+                monitor.dpi = Vector2f(mode->width * 25.4f / output.physical_width,
+                                       mode->height * 25.4f / output.physical_height);
+        }
+
+        monitors.push_back(monitor);
+    }
+
+    return monitors;
+}
+
 } // namespace priv
 
 } // namespace sf
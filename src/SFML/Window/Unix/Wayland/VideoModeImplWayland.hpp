@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML/Window/Monitor.hpp>
 #include <SFML/Window/VideoMode.hpp>
 
 
@@ -58,6 +59,14 @@ public:
     ///
     ////////////////////////////////////////////////////////////
     static VideoMode getDesktopMode();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the list of the connected monitors
+    ///
+    /// \return Array filled with the monitors
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::vector<Monitor> getMonitors();
 };
 
 } // namespace priv
@@ -27,8 +27,11 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Window/Unix/Wayland/WindowImplWayland.hpp>
 #include <SFML/Window/Unix/Wayland/ClipboardImplWayland.hpp>
+#include <SFML/Window/Unix/Wayland/CursorImplWayland.hpp>
+#include <SFML/Window/Unix/CursorImpl.hpp>
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
 #include <SFML/Window/Unix/Wayland/InputImplWayland.hpp>
+#include <SFML/Window/JoystickImpl.hpp>
 #include <SFML/System/Utf.hpp>
 #include <SFML/System/Err.hpp>
 #include <SFML/System/Mutex.hpp>
@@ -39,16 +42,56 @@
 #include <unistd.h>
 #include <libgen.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
 #include <algorithm>
+#include <limits>
 #include <vector>
 #include <string>
 #include <cstring>
+#include <ctime>
 
 ////////////////////////////////////////////////////////////
 // Private data
 ////////////////////////////////////////////////////////////
 namespace
 {
+    // Input comes on the default queue, which the event thread of any window
+    // may dispatch: the handlers write to the event queues of other windows,
+    // so dispatching and draining them is serialized
+    sf::Mutex eventMutex;
+
+    // Wrap a global, so that the objects it creates get their events on
+    // the given queue from the start (setting the queue after creation
+    // would race with other threads reading the display)
+    template <typename T>
+    T* queue_wrapper(T* global, struct wl_event_queue* queue)
+    {
+        T* wrapper = static_cast<T*>(wl_proxy_create_wrapper(global));
+        wl_proxy_set_queue(reinterpret_cast<struct wl_proxy*>(wrapper), queue);
+        return wrapper;
+    }
+
+    // Grow a (left, top, width, height) rectangle to also cover another one
+    void merge_rect(int* target, const int* rect)
+    {
+        if ((rect[2] <= 0) || (rect[3] <= 0))
+            return;
+
+        if ((target[2] <= 0) || (target[3] <= 0))
+        {
+            std::copy(rect, rect + 4, target);
+            return;
+        }
+
+        int right  = std::max(target[0] + target[2], rect[0] + rect[2]);
+        int bottom = std::max(target[1] + target[3], rect[1] + rect[3]);
+        target[0] = std::min(target[0], rect[0]);
+        target[1] = std::min(target[1], rect[1]);
+        target[2] = right - target[0];
+        target[3] = bottom - target[1];
+    }
+
     sf::Keyboard::Key keysym_to_key(uint32_t symbol)
     {
         switch (symbol)
@@ -217,6 +260,76 @@ void window_xdg_toplevel_close(void *data,
     WindowImplWayland* impl = (WindowImplWayland*)data;
     impl->handleWaylandToplevelClose(xdg_toplevel);
 }
+void window_frame_done(void *data,
+                       struct wl_callback *callback,
+                       uint32_t time) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandFrameDone(time);
+}
+void window_cursor_frame_done(void *data,
+                              struct wl_callback *callback,
+                              uint32_t time) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandCursorFrameDone(time);
+}
+void window_presentation_sync_output(void *data,
+                                     struct wp_presentation_feedback *feedback,
+                                     struct wl_output *output) {
+    // Only one output is tracked for now
+}
+void window_presentation_presented(void *data,
+                                   struct wp_presentation_feedback *feedback,
+                                   uint32_t tv_sec_hi,
+                                   uint32_t tv_sec_lo,
+                                   uint32_t tv_nsec,
+                                   uint32_t refresh,
+                                   uint32_t seq_hi,
+                                   uint32_t seq_lo,
+                                   uint32_t flags) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    Int64 seconds = ((Int64)tv_sec_hi << 32) | tv_sec_lo;
+    Time timestamp = microseconds(seconds * 1000000 + tv_nsec / 1000);
+    impl->handleWaylandFramePresented(feedback, timestamp, refresh, flags);
+}
+void window_presentation_discarded(void *data,
+                                   struct wp_presentation_feedback *feedback) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandFrameDiscarded(feedback);
+}
+void window_surface_enter(void *data,
+                          struct wl_surface *surface,
+                          struct wl_output *output) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandSurfaceEnter(output);
+}
+void window_surface_leave(void *data,
+                          struct wl_surface *surface,
+                          struct wl_output *output) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandSurfaceLeave(output);
+}
+void window_preferred_scale(void *data,
+                            struct wp_fractional_scale_v1 *fractional_scale,
+                            uint32_t scale) {
+    WindowImplWayland* impl = (WindowImplWayland*)data;
+    impl->handleWaylandPreferredScale(scale);
+}
+struct wp_fractional_scale_v1_listener window_fractional_scale_listener {
+    window_preferred_scale
+};
+void window_buffer_release(void *data,
+                           struct wl_buffer *buffer) {
+    // The buffer can be written again
+    bool* busy = (bool*)data;
+    *busy = false;
+}
+struct wl_buffer_listener window_buffer_listener {
+    window_buffer_release
+};
+struct wl_surface_listener window_surface_listener {
+    window_surface_enter,
+    window_surface_leave
+};
 struct xdg_surface_listener window_xdg_surface_listener {
     window_xdg_surface_configure
 };
@@ -224,6 +337,28 @@ struct xdg_toplevel_listener window_xdg_toplevel_listener {
     window_xdg_toplevel_configure,
     window_xdg_toplevel_close
 };
+struct wl_callback_listener window_frame_listener {
+    window_frame_done
+};
+struct wl_callback_listener window_cursor_frame_listener {
+    window_cursor_frame_done
+};
+struct wp_presentation_feedback_listener window_presentation_listener {
+    window_presentation_sync_output,
+    window_presentation_presented,
+    window_presentation_discarded
+};
+
+
+////////////////////////////////////////////////////////////
+WindowImplWayland* WindowImplWayland::fromSurface(struct wl_surface* surface)
+{
+    // Cursor surfaces carry other user data, and destroyed surfaces are NULL
+    if (!surface || (wl_proxy_get_listener(reinterpret_cast<struct wl_proxy*>(surface)) != &window_surface_listener))
+        return NULL;
+
+    return static_cast<WindowImplWayland*>(wl_surface_get_user_data(surface));
+}
 
 
 void WindowImplWayland::handleWaylandSurfaceConfigure(struct xdg_surface *xdg_surface,
@@ -251,18 +386,23 @@ void WindowImplWayland::handleWaylandToplevelConfigure(
         evt.size.height = new_size.y;
         m_window_size = new_size;
         m_new_events.push_back(evt);
+        updateBufferSize();
     }
-
-    wl_egl_window_resize(m_egl_window,
-                 width,
-                 height, 0, 0);
 }
-void WindowImplWayland::handleWaylandPointerEnter() {
+void WindowImplWayland::handleWaylandPointerEnter(uint32_t serial) {
+    // The cursor must be set again every time the pointer enters
+    m_pointer_serial = serial;
+    m_cursor_buffer = NULL;
+    updateCursor(0);
+
     Event evt;
     evt.type = Event::MouseEntered;
     m_new_events.push_back(evt);
 }
 void WindowImplWayland::handleWaylandPointerLeave() {
+    // The frame ending the leave is not sent to us anymore
+    flushPointerFrame();
+
     Event evt;
     evt.type = Event::MouseLeft;
     m_new_events.push_back(evt);
@@ -294,14 +434,23 @@ void WindowImplWayland::handleWaylandKeyboardKey(uint32_t time,uint32_t key,uint
     evt.key.alt = alt;
     m_new_events.push_back(evt);
 }
+void WindowImplWayland::handleWaylandKeyboardRepeat(uint32_t key, uint32_t letter, bool shift, bool control, bool system, bool alt) {
+    if (!m_keyRepeat)
+        return;
+
+    handleWaylandKeyboardKey(0, key, WL_KEYBOARD_KEY_STATE_PRESSED, shift, control, system, alt);
+    if (letter)
+        handleWaylandKeyboardText(letter);
+}
 void WindowImplWayland::handleWaylandPointerMotion(uint32_t time,double x, double y) {
     m_current_pointer_position.x = x;
     m_current_pointer_position.y = y;
-    Event evt;
-    evt.type = Event::MouseMoved;
-    evt.mouseMove.x = std::floor(m_current_pointer_position.x);
-    evt.mouseMove.y = std::floor(m_current_pointer_position.y);
-    m_new_events.push_back(evt);
+    m_pointer_frame.moved = true;
+}
+void WindowImplWayland::handleWaylandPointerRelativeMotion(double dx, double dy) {
+    m_pointer_frame.rawDelta.x += dx;
+    m_pointer_frame.rawDelta.y += dy;
+    m_pointer_frame.rawMoved = true;
 }
 void WindowImplWayland::handleWaylandPointerButton(uint32_t time,uint32_t button,uint32_t state) {
     Event evt;
@@ -326,31 +475,356 @@ void WindowImplWayland::handleWaylandPointerButton(uint32_t time,uint32_t button
         err() << "Unidentified button " << button << std::endl;
         std::abort();
     }
-    evt.mouseButton.x = std::floor(m_current_pointer_position.x);
-    evt.mouseButton.y = std::floor(m_current_pointer_position.y);
-    m_new_events.push_back(evt);
+    m_pointer_frame.buttons.push_back(evt);
+}
+void WindowImplWayland::handleWaylandFrameDone(uint32_t time) {
+    wl_callback_destroy(m_frame_callback);
+    m_frame_callback = NULL;
+
+    Lock lock(m_frame_mutex);
+
+    // The refresh rate of the output we entered last beats any guess
+    if (m_output_refresh > 0) {
+        m_frame_interval = microseconds(1000000000ll / m_output_refresh);
+    } else if (m_frame_clock.getElapsedTime() < milliseconds(100)) {
+        // Consecutive frames: smooth the measured interval
+        Time measured = milliseconds(time - m_frame_time);
+        if (m_frame_interval == Time::Zero) {
+            m_frame_interval = measured;
+        } else {
+            m_frame_interval = (m_frame_interval * 7ll + measured) / 8ll;
+        }
+    }
+
+    m_frame_time = time;
+    m_frame_clock.restart();
+}
+void WindowImplWayland::handleWaylandSurfaceEnter(struct wl_output* output) {
+    m_outputs.erase(std::remove(m_outputs.begin(), m_outputs.end(), output), m_outputs.end());
+    m_outputs.push_back(output);
+    updateOutputRefresh();
+    updateBufferSizeAndNotify();
+    if (getCursorScale() != m_cursor_scale)
+        updateCursor(0);
+}
+void WindowImplWayland::handleWaylandSurfaceLeave(struct wl_output* output) {
+    m_outputs.erase(std::remove(m_outputs.begin(), m_outputs.end(), output), m_outputs.end());
+    updateOutputRefresh();
+    updateBufferSizeAndNotify();
+    if (getCursorScale() != m_cursor_scale)
+        updateCursor(0);
+}
+void WindowImplWayland::handleWaylandPreferredScale(uint32_t scale) {
+    m_preferred_scale = scale;
+    updateBufferSizeAndNotify();
+    if (getCursorScale() != m_cursor_scale)
+        updateCursor(0);
+}
+void WindowImplWayland::handleWaylandCursorFrameDone(uint32_t time) {
+    wl_callback_destroy(m_cursor_frame_callback);
+    m_cursor_frame_callback = NULL;
+    updateCursor(time);
+}
+void WindowImplWayland::handleWaylandOutputRemoved(struct wl_output* output) {
+    handleWaylandSurfaceLeave(output);
+}
+void WindowImplWayland::handleWaylandFramePresented(struct wp_presentation_feedback* feedback, Time timestamp, uint32_t refresh, uint32_t flags) {
+    FrameTiming timing;
+    timing.presented = true;
+    timing.timestamp = timestamp;
+    timing.refreshInterval = microseconds(refresh / 1000);
+    timing.vsync = (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC) != 0;
+
+    // The compositor's prediction is more precise than the output mode
+    if (refresh > 0)
+    {
+        Lock lock(m_frame_mutex);
+        m_frame_interval = timing.refreshInterval;
+    }
+
+    finishFrameFeedback(feedback, timing);
+}
+void WindowImplWayland::handleWaylandFrameDiscarded(struct wp_presentation_feedback* feedback) {
+    FrameTiming timing;
+    timing.presented = false;
+    finishFrameFeedback(feedback, timing);
 }
 void WindowImplWayland::handleWaylandPointerAxisDiscrete(uint32_t axis, int val) {
-    if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL) {
+    if (axis < 2)
+        m_pointer_frame.discrete[axis] += val;
+}
+
+void WindowImplWayland::handleWaylandPointerAxis(uint32_t time,uint32_t axis, double val) {
+    if (axis < 2) {
+        m_pointer_frame.axis[axis] += val;
+        m_pointer_frame.axisSet[axis] = true;
+    }
+}
+
+void WindowImplWayland::handleWaylandPointerFrame() {
+    flushPointerFrame();
+}
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::flushPointerFrame()
+{
+    int x = std::floor(m_current_pointer_position.x);
+    int y = std::floor(m_current_pointer_position.y);
+
+    if (m_pointer_frame.moved)
+    {
+        Event evt;
+        evt.type = Event::MouseMoved;
+        evt.mouseMove.x = x;
+        evt.mouseMove.y = y;
+        pushMotionEvent(evt);
+    }
+
+    if (m_pointer_frame.rawMoved)
+    {
+        Event evt;
+        evt.type = Event::MouseMovedRaw;
+        evt.mouseMoveRaw.dx = m_pointer_frame.rawDelta.x;
+        evt.mouseMoveRaw.dy = m_pointer_frame.rawDelta.y;
+        pushMotionEvent(evt);
+    }
+
+    for (std::size_t i = 0; i < m_pointer_frame.buttons.size(); ++i)
+    {
+        Event evt = m_pointer_frame.buttons[i];
+        evt.mouseButton.x = x;
+        evt.mouseButton.y = y;
+        m_new_events.push_back(evt);
+    }
+
+    if (m_pointer_frame.discrete[WL_POINTER_AXIS_VERTICAL_SCROLL] != 0)
+    {
         Event evt;
         evt.type = Event::MouseWheelMoved;
-        evt.mouseWheel.delta = val;
-        evt.mouseWheel.x = std::floor(m_current_pointer_position.x);
-        evt.mouseWheel.y = std::floor(m_current_pointer_position.y);
+        evt.mouseWheel.delta = m_pointer_frame.discrete[WL_POINTER_AXIS_VERTICAL_SCROLL];
+        evt.mouseWheel.x = x;
+        evt.mouseWheel.y = y;
+        m_new_events.push_back(evt);
+    }
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (!m_pointer_frame.axisSet[axis])
+            continue;
+
+        Event evt;
+        evt.type = Event::MouseWheelScrolled;
+        evt.mouseWheelScroll.wheel = axis == WL_POINTER_AXIS_VERTICAL_SCROLL ? Mouse::VerticalWheel : Mouse::HorizontalWheel;
+        evt.mouseWheelScroll.delta = m_pointer_frame.axis[axis];
+        evt.mouseWheelScroll.x = x;
+        evt.mouseWheelScroll.y = y;
         m_new_events.push_back(evt);
     }
 
+    m_pointer_frame.moved = false;
+    m_pointer_frame.rawDelta = Vector2f();
+    m_pointer_frame.rawMoved = false;
+    m_pointer_frame.buttons.clear();
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        m_pointer_frame.axis[axis] = 0;
+        m_pointer_frame.axisSet[axis] = false;
+        m_pointer_frame.discrete[axis] = 0;
+    }
 }
 
-void WindowImplWayland::handleWaylandPointerAxis(uint32_t time,uint32_t axis, double val) {
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::pushMotionEvent(const Event& event)
+{
+    if (m_coalesceMotion)
+    {
+        // Look for an event of the same type among the trailing motion events
+        for (std::deque<Event>::reverse_iterator it = m_new_events.rbegin(); it != m_new_events.rend(); ++it)
+        {
+            if ((it->type != Event::MouseMoved) && (it->type != Event::MouseMovedRaw))
+                break;
+
+            if (it->type != event.type)
+                continue;
+
+            if (event.type == Event::MouseMoved)
+            {
+                it->mouseMove = event.mouseMove;
+            }
+            else
+            {
+                it->mouseMoveRaw.dx += event.mouseMoveRaw.dx;
+                it->mouseMoveRaw.dy += event.mouseMoveRaw.dy;
+            }
+            return;
+        }
+    }
+
+    m_new_events.push_back(event);
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowImplWayland::updateBufferSize()
+{
+    Vector2u size = m_window_size;
+    int bufferScale = 1;
+    bool scaledByViewport = false;
+
+    if (m_highDpi && m_viewport && (m_preferred_scale > 0))
+    {
+        // Fractional scale: round halfway away from zero, like the compositor does
+        size.x = (m_window_size.x * m_preferred_scale + 60) / 120;
+        size.y = (m_window_size.y * m_preferred_scale + 60) / 120;
+        scaledByViewport = true;
+    }
+    else
+    {
+        if (m_highDpi)
+        {
+            // Integer scale: render for the densest output showing the window
+            for (std::size_t i = 0; i < m_outputs.size(); ++i)
+                bufferScale = std::max(bufferScale, m_display->getOutputScale(m_outputs[i]));
+        }
+        size.x *= bufferScale;
+        size.y *= bufferScale;
+    }
+
+    if (m_viewport && (m_render_scale != 1.f))
+    {
+        // The viewport stretches the whole buffer, whatever its scale
+        size.x = std::max(static_cast<unsigned int>(size.x * m_render_scale + 0.5f), 1u);
+        size.y = std::max(static_cast<unsigned int>(size.y * m_render_scale + 0.5f), 1u);
+        bufferScale = 1;
+        scaledByViewport = true;
+    }
+
+    Vector2i destination(-1, -1);
+    if (scaledByViewport)
+        destination = Vector2i(m_window_size);
+
+    // The surface state must match the buffers, so it's the thread presenting
+    // them that applies it (see prepareCommit and resizeEglWindow)
+    Lock lock(m_frame_mutex);
+
+    bool changed = (size != m_framebuffer_size);
+    m_framebuffer_size = size;
+    m_buffer_scale = bufferScale;
+    m_viewport_destination = destination;
+
+    // Nobody presents through us (yet): nothing can race, apply it now
+    if (!m_presents_frames)
+        applySurfaceState(true);
+
+    return changed;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::applySurfaceState(bool resize)
+{
+    Lock lock(m_frame_mutex);
+
+    if (resize && (m_egl_size != m_framebuffer_size))
+    {
+        wl_egl_window_resize(m_egl_window, m_framebuffer_size.x, m_framebuffer_size.y, 0, 0);
+        m_egl_size = m_framebuffer_size;
+    }
+
+    if (m_buffer_scale != m_applied_scale)
+    {
+        wl_surface_set_buffer_scale(m_surface, m_buffer_scale);
+        m_applied_scale = m_buffer_scale;
+    }
+
+    if (m_viewport && (m_viewport_destination != m_applied_destination))
+    {
+        wp_viewport_set_destination(m_viewport, m_viewport_destination.x, m_viewport_destination.y);
+        m_applied_destination = m_viewport_destination;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::prepareCommit(const Vector2u& bufferSize)
+{
+    Lock lock(m_frame_mutex);
+
+    m_presents_frames = true;
+
+    // A frame rendered before a resize keeps the state of its size
+    if (bufferSize == m_framebuffer_size)
+        applySurfaceState(false);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::resizeEglWindow()
+{
+    Lock lock(m_frame_mutex);
+
+    m_presents_frames = true;
+
+    // The next buffers get the new size; the surface state follows with them
+    if (m_egl_size != m_framebuffer_size)
+    {
+        wl_egl_window_resize(m_egl_window, m_framebuffer_size.x, m_framebuffer_size.y, 0, 0);
+        m_egl_size = m_framebuffer_size;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updateOutputRefresh()
+{
+    // Cached, so that frame callbacks don't contend on the display mutex
+    int refresh = m_outputs.empty() ? 0 : m_display->getOutputRefresh(m_outputs.back());
+
+    Lock lock(m_frame_mutex);
+    m_output_refresh = refresh;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updateBufferSizeAndNotify()
+{
+    if (!updateBufferSize())
+        return;
+
+    // Let the application resize its viewport, even if the window size is the same
     Event evt;
-    evt.type = Event::MouseWheelScrolled;
-    evt.mouseWheelScroll.wheel = axis == WL_POINTER_AXIS_VERTICAL_SCROLL ? Mouse::VerticalWheel : Mouse::HorizontalWheel;
-    evt.mouseWheelScroll.delta = val;
-    evt.mouseWheelScroll.x = std::floor(m_current_pointer_position.x);
-    evt.mouseWheelScroll.y = std::floor(m_current_pointer_position.y);
+    evt.type = Event::Resized;
+    evt.size.width = m_window_size.x;
+    evt.size.height = m_window_size.y;
     m_new_events.push_back(evt);
+}
+
 
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updatePointerConstraint()
+{
+    if (m_locked_pointer)
+    {
+        zwp_locked_pointer_v1_destroy(m_locked_pointer);
+        m_locked_pointer = NULL;
+    }
+    if (m_confined_pointer)
+    {
+        zwp_confined_pointer_v1_destroy(m_confined_pointer);
+        m_confined_pointer = NULL;
+    }
+
+    if (!m_cursorGrabbed || !m_display->pointer)
+        return;
+
+    // Persistent constraints come back by themselves when the window regains the pointer
+    if (m_cursorVisible)
+        m_confined_pointer = zwp_pointer_constraints_v1_confine_pointer(m_display->pointer_constraints, m_surface, m_display->pointer,
+                                                                        NULL, ZWP_POINTER_CONSTRAINTS_V1_LIFETIME_PERSISTENT);
+    else
+        m_locked_pointer = zwp_pointer_constraints_v1_lock_pointer(m_display->pointer_constraints, m_surface, m_display->pointer,
+                                                                   NULL, ZWP_POINTER_CONSTRAINTS_V1_LIFETIME_PERSISTENT);
 }
 
 ////////////////////////////////////////////////////////////
@@ -373,8 +847,62 @@ m_windowMapped   (false),
 //m_iconPixmap     (0),
 //m_iconMaskPixmap (0),
 //m_lastInputTime  (0)
-m_xdg_initial_configure_seen(false)
+m_queue          (NULL),
+m_frame_queue    (NULL),
+m_presentation   (NULL),
+m_frame_surface  (NULL),
+m_xdg_initial_configure_seen(false),
+m_frame_callback (NULL),
+m_frame_interval (Time::Zero),
+m_frame_time     (0),
+m_coalesceMotion (false),
+m_locked_pointer (NULL),
+m_confined_pointer(NULL),
+m_cursorVisible  (true),
+m_cursor         (NULL),
+m_cursor_surface (NULL),
+m_cursor_frame_callback(NULL),
+m_cursor_buffer  (NULL),
+m_cursor_hotspot (0, 0),
+m_cursor_scale   (0),
+m_pointer_serial (0),
+m_shm_memory     (NULL),
+m_shm_memory_size(0),
+m_shm_current    (-1),
+m_shm_last       (-1),
+m_tearing_allowed(false),
+m_vsync          (false),
+m_tearing_control(NULL),
+m_highDpi        (false),
+m_preferred_scale(0),
+m_render_scale   (1.f),
+m_viewport       (NULL),
+m_fractional_scale(NULL),
+m_frame_count    (0),
+m_output_refresh (0),
+m_buffer_scale   (1),
+m_viewport_destination(-1, -1),
+m_presents_frames(false),
+m_applied_scale  (1),
+m_applied_destination(-1, -1),
+m_disconnect_notified(false)
 {
+    m_pointer_frame.moved = false;
+    m_pointer_frame.rawMoved = false;
+    for (int i = 0; i < 2; ++i)
+    {
+        m_shm_buffers[i].buffer = NULL;
+        m_shm_buffers[i].pixels = NULL;
+        m_shm_buffers[i].busy = false;
+        std::fill(m_shm_buffers[i].stale, m_shm_buffers[i].stale + 4, 0);
+    }
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        m_pointer_frame.axis[axis] = 0;
+        m_pointer_frame.axisSet[axis] = false;
+        m_pointer_frame.discrete[axis] = 0;
+    }
+
     m_window_size.x = mode.width;
     m_window_size.y = mode.height;
 
@@ -386,10 +914,33 @@ m_xdg_initial_configure_seen(false)
 
     m_display->window_list.push_back(this);
 
-    m_surface = wl_compositor_create_surface(m_display->compositor);
+    // The objects of the window get their own event queue, so that waiting
+    // for a frame doesn't dispatch the events of other windows, nor input.
+    // Frame callbacks, presentation feedback and shm buffer releases have
+    // a queue of their own, only dispatched by the thread presenting frames:
+    // the two threads never run the handlers of the same events.
+    m_queue = wl_display_create_queue(m_display->display);
+    m_frame_queue = wl_display_create_queue(m_display->display);
+    if (m_display->presentation)
+        m_presentation = queue_wrapper(m_display->presentation, m_frame_queue);
+
+    // Objects created from the surfaces inherit their queue; frame callbacks
+    // of the window go through a wrapper on the frame queue instead
+    struct wl_compositor* compositor = queue_wrapper(m_display->compositor, m_queue);
+    m_surface = wl_compositor_create_surface(compositor);
+    // Frames of animated cursors are driven by the queue of the window as well
+    m_cursor_surface = wl_compositor_create_surface(compositor);
+    wl_proxy_set_queue(reinterpret_cast<struct wl_proxy*>(m_cursor_surface), m_queue);
+    wl_proxy_wrapper_destroy(compositor);
+    wl_surface_add_listener(m_surface, &window_surface_listener, this);
+    m_frame_surface = queue_wrapper(m_surface, m_frame_queue);
     m_egl_window = wl_egl_window_create(m_surface, m_window_size.x, m_window_size.y);
+    m_framebuffer_size = m_window_size;
+    m_egl_size = m_window_size;
 
-    m_xdg_surface = xdg_wm_base_get_xdg_surface(m_display->xdg_wm_base, m_surface);
+    struct xdg_wm_base* wmBase = queue_wrapper(m_display->xdg_wm_base, m_queue);
+    m_xdg_surface = xdg_wm_base_get_xdg_surface(wmBase, m_surface);
+    wl_proxy_wrapper_destroy(wmBase);
     m_xdg_toplevel = xdg_surface_get_toplevel(m_xdg_surface);
     xdg_surface_add_listener(m_xdg_surface, &window_xdg_surface_listener, this);
     xdg_toplevel_add_listener(m_xdg_toplevel, &window_xdg_toplevel_listener, this);
@@ -400,15 +951,45 @@ m_xdg_initial_configure_seen(false)
     xdg_toplevel_set_title(m_xdg_toplevel, (const char*)title.toUtf8().c_str());
 
     if (m_fullscreen) {
-        xdg_toplevel_set_fullscreen(m_xdg_toplevel, NULL);
+        xdg_toplevel_set_fullscreen(m_xdg_toplevel, findFullscreenOutput(mode));
     }
 
+    updateOpaqueRegion();
     wl_surface_commit(m_surface);
 
     wl_display_flush(m_display->display);
 
 
     initialize();
+
+    // Fullscreen windows start with a grabbed cursor
+    updatePointerConstraint();
+}
+
+
+////////////////////////////////////////////////////////////
+struct wl_output* WindowImplWayland::findFullscreenOutput(const VideoMode& mode) const
+{
+    // Prefer an output already showing the mode, then any output supporting it
+    struct wl_output* found = NULL;
+    std::vector<WaylandOutput> outputs = GetWaylandOutputs(m_display);
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        for (std::size_t j = 0; j < outputs[i].modes.size(); ++j)
+        {
+            const WaylandOutputMode& outputMode = outputs[i].modes[j];
+            if ((outputMode.width != static_cast<int>(mode.width)) || (outputMode.height != static_cast<int>(mode.height)))
+                continue;
+
+            if (outputMode.current)
+                return outputs[i].output;
+            if (!found)
+                found = outputs[i].output;
+        }
+    }
+
+    // Without a match, the compositor picks the output
+    return found;
 }
 
 
@@ -431,6 +1012,13 @@ WindowImplWayland::~WindowImplWayland()
     // Cleanup graphical resources
     cleanup();
 
+    // Drop the events still queued for the destroyed objects
+    if (m_presentation)
+        wl_proxy_wrapper_destroy(m_presentation);
+    wl_proxy_wrapper_destroy(m_frame_surface);
+    wl_event_queue_destroy(m_frame_queue);
+    wl_event_queue_destroy(m_queue);
+
     // Close the connection with the X server
     CloseWaylandDisplay(m_display);
 }
@@ -448,10 +1036,26 @@ WindowHandle WindowImplWayland::getSystemHandle() const
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::processEvents()
 {
+    Lock lock(eventMutex);
+
+    // Fetch whatever the compositor has sent us, without blocking
+    readDisplayEvents(0, NULL);
+
     // Process events. The callbacks related to this window will call
     // implementation functions that in turn do stuff and append to the
-    // m_new_events queue
+    // m_new_events queue. Input events come from the seat, on the default
+    // queue; the events of the surface come on the queue of the window
     wl_display_dispatch_pending(m_display->display);
+    wl_display_dispatch_queue_pending(m_display->display, m_queue);
+
+    // The window can't be used anymore: ask the application to close it
+    if (m_display->disconnected && !m_disconnect_notified)
+    {
+        Event evt;
+        evt.type = Event::Closed;
+        m_new_events.push_back(evt);
+        m_disconnect_notified = true;
+    }
 
     Event e;
     while (!m_new_events.empty()) {
@@ -465,6 +1069,128 @@ void WindowImplWayland::processEvents()
 }
 
 
+////////////////////////////////////////////////////////////
+void WindowImplWayland::waitEvents(Time timeout)
+{
+    // There's nothing left to wait for on a broken connection: processEvents
+    // sends the Closed event once, then only joysticks can produce events,
+    // so poll them at the usual rate rather than spinning
+    if (m_display->disconnected)
+    {
+        Time interval = milliseconds(10);
+        sleep(((timeout != Time::Zero) && (timeout < interval)) ? timeout : interval);
+        return;
+    }
+
+    // Events already read for this window are ready to be processed
+    {
+        Lock lock(eventMutex);
+        if (wl_display_dispatch_queue_pending(m_display->display, m_queue) > 0)
+            return;
+    }
+
+    if (timeout == Time::Zero)
+        readDisplayEvents(-1, NULL);
+    else
+        readDisplayEvents(std::max(static_cast<int>(timeout.asMilliseconds()), 1), NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::readDisplayEvents(int timeout, struct wl_event_queue* queue)
+{
+    struct wl_display* display = m_display->display;
+
+    // Nothing will ever come from a broken connection
+    if (m_display->disconnected)
+        return;
+
+    // Events already queued (read by another thread, or by eglSwapBuffers)
+    // must be dispatched before we are allowed to read again
+    if ((queue ? wl_display_prepare_read_queue(display, queue) : wl_display_prepare_read(display)) != 0)
+        return;
+
+    // Make sure the compositor got our requests before we go to sleep
+    wl_display_flush(display);
+
+    std::vector<pollfd> descriptors(1);
+    descriptors[0].fd      = wl_display_get_fd(display);
+    descriptors[0].events  = POLLIN;
+    descriptors[0].revents = 0;
+
+    if (!queue)
+    {
+        pollfd descriptor;
+        descriptor.fd      = m_display->keyboard_repeat_fd;
+        descriptor.events  = POLLIN;
+        descriptor.revents = 0;
+        descriptors.push_back(descriptor);
+    }
+
+    if (!queue && (timeout != 0))
+    {
+        // Joystick connections and state changes must wake us up as well.
+        // Sensors have no implementation (thus nothing to wait on) here.
+        std::vector<int> files;
+#if defined(SFML_SYSTEM_LINUX)
+        bool signalled = JoystickImpl::getFileDescriptors(files);
+#else
+        bool signalled = false;
+#endif
+
+        // Fall back to polling joysticks at the usual rate
+        if (!signalled && ((timeout < 0) || (timeout > 10)))
+            timeout = 10;
+
+        for (std::vector<int>::const_iterator it = files.begin(); it != files.end(); ++it)
+        {
+            pollfd descriptor;
+            descriptor.fd      = *it;
+            descriptor.events  = POLLIN;
+            descriptor.revents = 0;
+            descriptors.push_back(descriptor);
+        }
+
+        // Clipboard transfers progress while we sleep
+        priv::ClipboardImplWayland::getPollDescriptors(descriptors);
+    }
+
+    int ready = poll(&descriptors[0], descriptors.size(), timeout);
+    if ((ready > 0) && (descriptors[0].revents & POLLIN))
+    {
+        // The last events sent before a hangup are still worth reading
+        if (wl_display_read_events(display) < 0)
+            handleDisconnection();
+    }
+    else
+    {
+        wl_display_cancel_read(display);
+
+        // Polling a dead connection again would return immediately, forever
+        if ((ready > 0) && (descriptors[0].revents & (POLLHUP | POLLERR)))
+            handleDisconnection();
+    }
+
+    if (!queue && (descriptors[1].revents & POLLIN))
+    {
+        Lock lock(eventMutex);
+        ProcessWaylandKeyRepeat(m_display);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::handleDisconnection()
+{
+    // Any thread may notice it first: the event thread tells the application
+    if (!m_display->disconnected)
+    {
+        err() << "Lost the connection to the Wayland compositor" << std::endl;
+        m_display->disconnected = true;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2i WindowImplWayland::getPosition() const
 {
@@ -514,18 +1240,102 @@ void WindowImplWayland::setVisible(bool visible)
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::setMouseCursorVisible(bool visible)
 {
+    if (visible == m_cursorVisible)
+        return;
+
+    m_cursorVisible = visible;
+    updatePointerConstraint();
+    updateCursor(0);
 }
 
 
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::setMouseCursor(const CursorImpl& cursor)
 {
+    m_cursor = cursor.m_wayland;
+    updateCursor(0);
+}
+
+
+////////////////////////////////////////////////////////////
+int WindowImplWayland::getCursorScale() const
+{
+    // Fractional scales round up, the compositor scales the cursor down
+    if (m_preferred_scale > 0)
+        return std::max(static_cast<int>((m_preferred_scale + 119) / 120), 1);
+
+    int scale = 1;
+    for (std::size_t i = 0; i < m_outputs.size(); ++i)
+        scale = std::max(scale, m_display->getOutputScale(m_outputs[i]));
+    return scale;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updateCursor(uint32_t time)
+{
+    if (!m_display->pointer || (m_display->pointer_focus_window != this))
+        return;
+
+    if (!m_cursorVisible)
+    {
+        wl_pointer_set_cursor(m_display->pointer, m_pointer_serial, NULL, 0, 0);
+        m_cursor_buffer = NULL;
+        return;
+    }
+
+    int scale = getCursorScale();
+    CursorImplWayland::Image image;
+    bool found = m_cursor ? m_cursor->getImage(scale, time, image)
+                          : CursorImplWayland::getSystemImage(m_display, Cursor::Arrow, scale, time, image);
+
+    // Without an image, the compositor keeps showing its own cursor
+    if (!found)
+        return;
+
+    // Images were uploaded once by the cursor or the theme: switching is
+    // only a matter of attaching another buffer
+    bool changed = (image.buffer != m_cursor_buffer) || (image.hotspot != m_cursor_hotspot) || (image.scale != m_cursor_scale);
+    if (changed)
+    {
+        UseWaylandCursorBuffer(m_display, image.buffer);
+        wl_surface_attach(m_cursor_surface, image.buffer, 0, 0);
+        wl_surface_set_buffer_scale(m_cursor_surface, image.scale);
+        wl_surface_damage(m_cursor_surface, 0, 0, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max());
+    }
+
+    // Animated cursors move on to the next frame when the compositor is ready for it
+    if (m_cursor_frame_callback)
+    {
+        wl_callback_destroy(m_cursor_frame_callback);
+        m_cursor_frame_callback = NULL;
+    }
+    if (image.delay > 0)
+    {
+        m_cursor_frame_callback = wl_surface_frame(m_cursor_surface);
+        wl_callback_add_listener(m_cursor_frame_callback, &window_cursor_frame_listener, this);
+    }
+
+    if (changed || (image.delay > 0))
+        wl_surface_commit(m_cursor_surface);
+
+    if (changed)
+        wl_pointer_set_cursor(m_display->pointer, m_pointer_serial, m_cursor_surface, image.hotspot.x, image.hotspot.y);
+
+    m_cursor_buffer = image.buffer;
+    m_cursor_hotspot = image.hotspot;
+    m_cursor_scale = image.scale;
 }
 
 
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::setMouseCursorGrabbed(bool grabbed)
 {
+    if (grabbed == m_cursorGrabbed)
+        return;
+
+    m_cursorGrabbed = grabbed;
+    updatePointerConstraint();
 }
 
 
@@ -536,6 +1346,13 @@ void WindowImplWayland::setKeyRepeatEnabled(bool enabled)
 }
 
 
+////////////////////////////////////////////////////////////
+void WindowImplWayland::setMouseMoveCoalescingEnabled(bool enabled)
+{
+    m_coalesceMotion = enabled;
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::requestFocus()
 {
@@ -548,19 +1365,512 @@ bool WindowImplWayland::hasFocus() const
     return true;
 }
 
+////////////////////////////////////////////////////////////
+Time WindowImplWayland::getTimeUntilNextFrame() const
+{
+    Lock lock(m_frame_mutex);
+
+    if (m_frame_interval == Time::Zero)
+        return Time::Zero;
+
+    // Frames are presented at a regular pace, starting from the last one we saw
+    return m_frame_interval - (m_frame_clock.getElapsedTime() % m_frame_interval);
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowImplWayland::popFrameTiming(FrameTiming& timing)
+{
+    Lock lock(m_frame_mutex);
+
+    if (m_frame_timings.empty())
+        return false;
+
+    timing = m_frame_timings.front();
+    m_frame_timings.pop_front();
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::setHighDpiEnabled(bool enabled)
+{
+    if (enabled == m_highDpi)
+        return;
+
+    m_highDpi = enabled;
+
+    // Fractional scaling needs both the preferred scale and a viewport
+    if (m_highDpi && !m_viewport && m_display->viewporter && m_display->fractional_scale_manager)
+    {
+        {
+            // The thread presenting frames sets the destination of the viewport
+            Lock lock(m_frame_mutex);
+            m_viewport = wp_viewporter_get_viewport(m_display->viewporter, m_surface);
+        }
+        struct wp_fractional_scale_manager_v1* manager = queue_wrapper(m_display->fractional_scale_manager, m_queue);
+        m_fractional_scale = wp_fractional_scale_manager_v1_get_fractional_scale(manager, m_surface);
+        wl_proxy_wrapper_destroy(manager);
+        wp_fractional_scale_v1_add_listener(m_fractional_scale, &window_fractional_scale_listener, this);
+    }
+
+    updateBufferSizeAndNotify();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::setRenderScale(float scale)
+{
+    if (scale == m_render_scale)
+        return;
+
+    if (!m_display->viewporter)
+    {
+        err() << "Render scaling is not supported by the compositor (no wp_viewporter)" << std::endl;
+        return;
+    }
+
+    m_render_scale = scale;
+    if (!m_viewport)
+    {
+        // The thread presenting frames sets the destination of the viewport
+        Lock lock(m_frame_mutex);
+        m_viewport = wp_viewporter_get_viewport(m_display->viewporter, m_surface);
+    }
+
+    updateBufferSizeAndNotify();
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u WindowImplWayland::getFramebufferSize() const
+{
+    Lock lock(m_frame_mutex);
+    return m_framebuffer_size;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* WindowImplWayland::lockPixels()
+{
+    if (m_shm_current >= 0)
+        return m_shm_staging.empty() ? m_shm_buffers[m_shm_current].pixels : &m_shm_staging[0];
+
+    // Reallocate the buffers when the window is resized
+    Vector2u size = getFramebufferSize();
+    if (m_shm_size != size)
+    {
+        destroyShmBuffers();
+        if (!createShmBuffers(size))
+            return NULL;
+    }
+
+    // Wait until the compositor releases one of the buffers
+    while (m_shm_buffers[0].busy && m_shm_buffers[1].busy)
+    {
+        // Stop waiting if the connection is broken
+        if ((wl_display_dispatch_queue_pending(m_display->display, m_frame_queue) < 0) || m_display->disconnected)
+            return NULL;
+
+        if (m_shm_buffers[0].busy && m_shm_buffers[1].busy)
+            readDisplayEvents(-1, m_frame_queue);
+    }
+    m_shm_current = m_shm_buffers[0].busy ? 1 : 0;
+
+    // The buffer may have missed several frames: bring it up to date
+    ShmBuffer& current = m_shm_buffers[m_shm_current];
+    if ((m_shm_last >= 0) && (m_shm_last != m_shm_current))
+        copyShmRect(m_shm_buffers[m_shm_last].pixels, current.pixels, current.stale);
+    std::fill(current.stale, current.stale + 4, 0);
+
+    return m_shm_staging.empty() ? m_shm_buffers[m_shm_current].pixels : &m_shm_staging[0];
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::unlockPixels(int left, int top, unsigned int width, unsigned int height)
+{
+    if (m_shm_current < 0)
+        return;
+
+    ShmBuffer& current = m_shm_buffers[m_shm_current];
+
+    // Clip the damage to the buffer
+    int right  = std::min<int>(left + width, m_shm_size.x);
+    int bottom = std::min<int>(top + height, m_shm_size.y);
+    left = std::max(left, 0);
+    top  = std::max(top, 0);
+    int damage[4] = {left, top, std::max(right - left, 0), std::max(bottom - top, 0)};
+
+    // The other buffer misses this frame on top of those it already missed
+    merge_rect(m_shm_buffers[1 - m_shm_current].stale, damage);
+
+    // Without XBGR8888, convert the RGBA pixels to XRGB8888 (BGRX bytes)
+    if (!m_shm_staging.empty())
+    {
+        for (int y = top; y < bottom; ++y)
+        {
+            const Uint8* source = &m_shm_staging[(static_cast<std::size_t>(y) * m_shm_size.x + left) * 4];
+            Uint8* destination = current.pixels + (static_cast<std::size_t>(y) * m_shm_size.x + left) * 4;
+            for (int x = left; x < right; ++x, source += 4, destination += 4)
+            {
+                destination[0] = source[2];
+                destination[1] = source[1];
+                destination[2] = source[0];
+                destination[3] = 0xFF;
+            }
+        }
+    }
+
+    prepareCommit(m_shm_size);
+    wl_surface_attach(m_surface, current.buffer, 0, 0);
+    if (m_display->compositor_version >= 4)
+        wl_surface_damage_buffer(m_surface, damage[0], damage[1], damage[2], damage[3]);
+    else
+        wl_surface_damage(m_surface, 0, 0, m_window_size.x, m_window_size.y);
+    requestFrame();
+    wl_surface_commit(m_surface);
+    wl_display_flush(m_display->display);
+
+    current.busy = true;
+    m_shm_last = m_shm_current;
+    m_shm_current = -1;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::addDamage(int left, int top, unsigned int width, unsigned int height)
+{
+    // Clip to the EGL window, EGL rejects rectangles outside of the surface
+    int right  = std::min<int>(left + width, m_egl_size.x);
+    int bottom = std::min<int>(top + height, m_egl_size.y);
+    left = std::max(left, 0);
+    top  = std::max(top, 0);
+    if ((right <= left) || (bottom <= top))
+        return;
+
+    m_damage.push_back(left);
+    m_damage.push_back(top);
+    m_damage.push_back(right - left);
+    m_damage.push_back(bottom - top);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::takeDamage(std::vector<int>& rects)
+{
+    rects.clear();
+    rects.swap(m_damage);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::addOpaqueArea(int left, int top, unsigned int width, unsigned int height)
+{
+    if ((width == 0) || (height == 0))
+        return;
+
+    m_opaque_areas.push_back(left);
+    m_opaque_areas.push_back(top);
+    m_opaque_areas.push_back(width);
+    m_opaque_areas.push_back(height);
+    updateOpaqueRegion();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::resetOpaqueArea()
+{
+    m_opaque_areas.clear();
+    updateOpaqueRegion();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updateOpaqueRegion()
+{
+    struct wl_region* region = wl_compositor_create_region(m_display->compositor);
+    if (m_opaque_areas.empty())
+    {
+        // SFML windows have no notion of transparency, whatever the alpha
+        // channel of their framebuffer; the compositor clips the region
+        // to the surface, whatever its size
+        wl_region_add(region, 0, 0, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max());
+    }
+    else
+    {
+        for (std::size_t i = 0; i < m_opaque_areas.size(); i += 4)
+            wl_region_add(region, m_opaque_areas[i], m_opaque_areas[i + 1], m_opaque_areas[i + 2], m_opaque_areas[i + 3]);
+    }
+    wl_surface_set_opaque_region(m_surface, region);
+    wl_region_destroy(region);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::setTearingAllowed(bool allowed)
+{
+    m_tearing_allowed = allowed;
+    updateTearingHint();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::setVerticalSyncHint(bool enabled)
+{
+    m_vsync = enabled;
+    updateTearingHint();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::updateTearingHint()
+{
+    // Without the protocol, frames are always synchronized
+    if (!m_display->tearing_control_manager)
+        return;
+
+    bool async = m_tearing_allowed && !m_vsync;
+    if (!m_tearing_control)
+    {
+        // The default hint is vsync: no need for an object until tearing is wanted
+        if (!async)
+            return;
+        m_tearing_control = wp_tearing_control_manager_v1_get_tearing_control(m_display->tearing_control_manager, m_surface);
+    }
+
+    wp_tearing_control_v1_set_presentation_hint(m_tearing_control, async ? WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC
+                                                                         : WP_TEARING_CONTROL_V1_PRESENTATION_HINT_VSYNC);
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowImplWayland::createShmBuffers(const Vector2u& size)
+{
+    if ((size.x == 0) || (size.y == 0))
+        return false;
+
+    std::size_t stride = static_cast<std::size_t>(size.x) * 4;
+    std::size_t bufferSize = stride * size.y;
+
+    int fd = memfd_create("sfml-shm", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        err() << "Failed to create shared memory for the window pixels" << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, bufferSize * 2) < 0)
+    {
+        err() << "Failed to allocate shared memory for the window pixels" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void* memory = mmap(NULL, bufferSize * 2, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        err() << "Failed to map shared memory for the window pixels" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    // The buffers keep the pool's memory alive, the pool itself isn't needed anymore
+    uint32_t format = m_display->shm_xbgr8888 ? WL_SHM_FORMAT_XBGR8888 : WL_SHM_FORMAT_XRGB8888;
+    // The buffers inherit the queue of the pool
+    struct wl_shm* shm = queue_wrapper(m_display->shm, m_frame_queue);
+    struct wl_shm_pool* pool = wl_shm_create_pool(shm, fd, bufferSize * 2);
+    wl_proxy_wrapper_destroy(shm);
+    for (int i = 0; i < 2; ++i)
+    {
+        ShmBuffer& buffer = m_shm_buffers[i];
+        buffer.buffer = wl_shm_pool_create_buffer(pool, bufferSize * i, size.x, size.y, stride, format);
+        buffer.pixels = static_cast<Uint8*>(memory) + bufferSize * i;
+        buffer.busy = false;
+        wl_buffer_add_listener(buffer.buffer, &window_buffer_listener, &buffer.busy);
+
+        // Nothing was presented from the new buffers yet
+        buffer.stale[0] = 0;
+        buffer.stale[1] = 0;
+        buffer.stale[2] = size.x;
+        buffer.stale[3] = size.y;
+    }
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    m_shm_memory = static_cast<Uint8*>(memory);
+    m_shm_memory_size = bufferSize * 2;
+    m_shm_size = size;
+    m_shm_last = -1;
+
+    // The pixels are converted on presentation if the compositor can't take RGBA bytes
+    if (!m_display->shm_xbgr8888)
+        m_shm_staging.assign(bufferSize, 0);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::destroyShmBuffers()
+{
+    // Buffers still in use by the compositor can be destroyed, it keeps its own mapping
+    for (int i = 0; i < 2; ++i)
+    {
+        if (m_shm_buffers[i].buffer)
+            wl_buffer_destroy(m_shm_buffers[i].buffer);
+        m_shm_buffers[i].buffer = NULL;
+        m_shm_buffers[i].pixels = NULL;
+        m_shm_buffers[i].busy = false;
+    }
+
+    if (m_shm_memory)
+        munmap(m_shm_memory, m_shm_memory_size);
+    m_shm_memory = NULL;
+    m_shm_memory_size = 0;
+    m_shm_size = Vector2u();
+    m_shm_current = -1;
+    m_shm_last = -1;
+    m_shm_staging.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::copyShmRect(const Uint8* source, Uint8* destination, const int* rect) const
+{
+    std::size_t offset = (static_cast<std::size_t>(rect[1]) * m_shm_size.x + rect[0]) * 4;
+    std::size_t length = static_cast<std::size_t>(rect[2]) * 4;
+    for (int y = 0; y < rect[3]; ++y, offset += m_shm_size.x * 4)
+        std::memcpy(destination + offset, source + offset, length);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::requestFrame()
+{
+    // Handle the frames shown since the last call: without v-sync, nothing
+    // else dispatches them (the event thread only reads them from the socket)
+    wl_display_dispatch_queue_pending(m_display->display, m_frame_queue);
+
+    // Every commit gets its own feedback, even if the previous one is still pending
+    if (m_presentation)
+    {
+        PendingFrame pending;
+        pending.feedback = wp_presentation_feedback(m_presentation, m_surface);
+        pending.frame = m_frame_count;
+        pending.submitted = getPresentationTime();
+        wp_presentation_feedback_add_listener(pending.feedback, &window_presentation_listener, this);
+        m_pending_frames.push_back(pending);
+    }
+    m_frame_count++;
+
+    // Keep the older callback if the previous frame wasn't shown yet
+    if (m_frame_callback)
+        return;
+
+    m_frame_callback = wl_surface_frame(m_frame_surface);
+    wl_callback_add_listener(m_frame_callback, &window_frame_listener, this);
+}
+
+
+////////////////////////////////////////////////////////////
+Time WindowImplWayland::getPresentationTime() const
+{
+    timespec now;
+    if (clock_gettime(m_display->presentation_clock, &now) != 0)
+        return Time::Zero;
+
+    return microseconds(static_cast<Int64>(now.tv_sec) * 1000000 + now.tv_nsec / 1000);
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::finishFrameFeedback(struct wp_presentation_feedback* feedback, FrameTiming& timing)
+{
+    for (std::deque<PendingFrame>::iterator it = m_pending_frames.begin(); it != m_pending_frames.end(); ++it)
+    {
+        if (it->feedback != feedback)
+            continue;
+
+        timing.frame = it->frame;
+        if (timing.presented && (it->submitted != Time::Zero) && (timing.timestamp > it->submitted))
+            timing.latency = timing.timestamp - it->submitted;
+
+        m_pending_frames.erase(it);
+        break;
+    }
+    wp_presentation_feedback_destroy(feedback);
+
+    // Only keep the most recent timings if the user doesn't read them
+    Lock lock(m_frame_mutex);
+    m_frame_timings.push_back(timing);
+    while (m_frame_timings.size() > 128)
+        m_frame_timings.pop_front();
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImplWayland::waitForFrame()
+{
+    // Hidden or occluded windows get no frame callbacks: give up after a
+    // few frames, so that the application keeps running at a low rate
+    Time limit;
+    {
+        Lock lock(m_frame_mutex);
+        limit = std::max(m_frame_interval * 4ll, milliseconds(100));
+    }
+
+    Clock clock;
+    while (m_frame_callback)
+    {
+        // Stop waiting if the connection is broken
+        if ((wl_display_dispatch_queue_pending(m_display->display, m_frame_queue) < 0) || m_display->disconnected)
+            break;
+
+        Time remaining = limit - clock.getElapsedTime();
+        if (remaining <= Time::Zero)
+            break;
+
+        if (m_frame_callback)
+            readDisplayEvents(std::max(static_cast<int>(remaining.asMilliseconds()), 1), m_frame_queue);
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::initialize()
 {
+    Lock lock(eventMutex);
+
     // Deep magic, see xdg shell docs about waiting for configure
     while (!m_xdg_initial_configure_seen) {
         wl_display_flush(m_display->display);
-        wl_display_dispatch(m_display->display);
+        wl_display_dispatch_queue(m_display->display, m_queue);
     }
 }
 
 ////////////////////////////////////////////////////////////
 void WindowImplWayland::cleanup()
 {
+    if (m_frame_callback)
+        wl_callback_destroy(m_frame_callback);
+
+    // Release the pointer lock or confinement before the surface goes away
+    m_cursorGrabbed = false;
+    updatePointerConstraint();
+
+    for (std::size_t i = 0; i < m_pending_frames.size(); ++i)
+        wp_presentation_feedback_destroy(m_pending_frames[i].feedback);
+    m_pending_frames.clear();
+
+    destroyShmBuffers();
+
+    if (m_fractional_scale)
+        wp_fractional_scale_v1_destroy(m_fractional_scale);
+    if (m_tearing_control)
+        wp_tearing_control_v1_destroy(m_tearing_control);
+    if (m_viewport)
+        wp_viewport_destroy(m_viewport);
+
     // Restore the previous video mode (in case we were running in fullscreen)
     wl_egl_window_destroy(m_egl_window);
     zxdg_toplevel_decoration_v1_destroy(m_xdg_toplevel_deco);
@@ -570,6 +1880,10 @@ void WindowImplWayland::cleanup()
 
     // Unhide the mouse cursor (in case it was hidden)
     setMouseCursorVisible(true);
+
+    if (m_cursor_frame_callback)
+        wl_callback_destroy(m_cursor_frame_callback);
+    wl_surface_destroy(m_cursor_surface);
 }
 
 } // namespace priv
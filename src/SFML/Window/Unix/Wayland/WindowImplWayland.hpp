@@ -31,8 +31,11 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/WindowImpl.hpp>
 #include <SFML/System/String.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Mutex.hpp>
 #include <SFML/Window/WindowStyle.hpp> // Prevent conflict with macro None from Xlib
 #include <deque>
+#include <vector>
 #include <SFML/Window/Unix/Wayland/DisplayWayland.hpp>
 
 
@@ -40,6 +43,8 @@ namespace sf
 {
 namespace priv
 {
+class CursorImplWayland;
+
 ////////////////////////////////////////////////////////////
 /// \brief Linux (X11) implementation of WindowImpl
 ///
@@ -171,6 +176,14 @@ public:
     ////////////////////////////////////////////////////////////
     virtual void setKeyRepeatEnabled(bool enabled);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the coalescing of mouse motion
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setMouseMoveCoalescingEnabled(bool enabled);
+
     ////////////////////////////////////////////////////////////
     /// \brief Request the current window to be made the active
     ///        foreground window
@@ -186,6 +199,175 @@ public:
     ////////////////////////////////////////////////////////////
     virtual bool hasFocus() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the estimated time until the next frame is presented
+    ///
+    /// \return Time until the next presentation, or Time::Zero if unknown
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Time getTimeUntilNextFrame() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the presentation timing of a displayed frame
+    ///
+    /// \param timing Timing to be filled
+    ///
+    /// \return True if a timing was returned, false if none is available
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool popFrameTiming(FrameTiming& timing);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allow or forbid tearing when presenting frames
+    ///
+    /// \param allowed True to allow tearing, false to forbid it
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setTearingAllowed(bool allowed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable rendering at the native resolution
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setHighDpiEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the resolution at which the window is rendered
+    ///
+    /// \param scale Ratio between the framebuffer size and its normal size
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setRenderScale(float scale);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the framebuffer of the window
+    ///
+    /// \return Size of the framebuffer, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Vector2u getFramebufferSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a pixel buffer to render the next frame into
+    ///
+    /// \return Pointer to the RGBA pixels of the framebuffer size,
+    ///         or null if no buffer could be allocated
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Uint8* lockPixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Present the frame rendered into the locked pixel buffer
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void unlockPixels(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area modified by the frame being rendered
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void addDamage(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area of the window as fully opaque
+    ///
+    /// \param left   X coordinate of the opaque area
+    /// \param top    Y coordinate of the opaque area
+    /// \param width  Width of the opaque area
+    /// \param height Height of the opaque area
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void addOpaqueArea(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restore the default opaque region of the window
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void resetOpaqueArea();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Take the areas declared with addDamage since the last frame
+    ///
+    /// \param rects Filled with (left, top, width, height) quadruplets,
+    ///              empty if the whole window changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void takeDamage(std::vector<int>& rects);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the surface state matching a buffer about to be committed
+    ///
+    /// The buffer scale and viewport change with the framebuffer
+    /// size, but only buffers of the new size may be committed
+    /// with them. Must be called by the thread presenting frames,
+    /// before each commit.
+    ///
+    /// \param bufferSize Size of the buffer, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepareCommit(const Vector2u& bufferSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give the EGL window the current framebuffer size
+    ///
+    /// Must be called by the thread presenting frames, between
+    /// two frames: resizing it while a frame is drawn or swapped
+    /// would race with EGL.
+    ///
+    ////////////////////////////////////////////////////////////
+    void resizeEglWindow();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the context of the window waits for vertical sync
+    ///
+    /// \param enabled True if vertical synchronization is enabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVerticalSyncHint(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Ask to be notified when the next committed frame is shown
+    ///
+    /// Also asks for presentation feedback on the frame, if the
+    /// compositor supports wp_presentation. Must be called once
+    /// per frame, before the surface commit (eglSwapBuffers).
+    ///
+    ////////////////////////////////////////////////////////////
+    void requestFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Block until the compositor wants a new frame
+    ///
+    /// Returns immediately if no frame callback is pending. Windows
+    /// that are hidden or occluded do not receive frame callbacks,
+    /// so the wait ends after a few frame intervals (at least
+    /// 100 ms): rendering to them slows down instead of blocking
+    /// the application.
+    ///
+    ////////////////////////////////////////////////////////////
+    void waitForFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the window owning a surface
+    ///
+    /// \param surface Surface received in an input event
+    ///
+    /// \return Window whose surface it is, or NULL if it isn't a window surface
+    ///
+    ////////////////////////////////////////////////////////////
+    static WindowImplWayland* fromSurface(struct wl_surface* surface);
 
 
     void handleWaylandSurfaceConfigure(struct xdg_surface *xdg_surface,
@@ -199,13 +381,24 @@ public:
     void handleWaylandKeyboardText(uint32_t letter);
     void handleWaylandPointerButton(uint32_t time,uint32_t button,uint32_t state);
     void handleWaylandPointerMotion(uint32_t time,double x, double y);
+    void handleWaylandPointerRelativeMotion(double dx, double dy);
     void handleWaylandKeyboardKey(uint32_t time,uint32_t key,uint32_t state,bool shift, bool control, bool system, bool alt);
+    void handleWaylandKeyboardRepeat(uint32_t key, uint32_t letter, bool shift, bool control, bool system, bool alt);
     void handleWaylandPointerAxis(uint32_t time,uint32_t axis, double val);
     void handleWaylandPointerAxisDiscrete(uint32_t axis, int val);
-    void handleWaylandPointerEnter();
+    void handleWaylandPointerFrame();
+    void handleWaylandPointerEnter(uint32_t serial);
     void handleWaylandPointerLeave();
     void handleWaylandKeyboardEnter();
     void handleWaylandKeyboardLeave();
+    void handleWaylandFrameDone(uint32_t time);
+    void handleWaylandCursorFrameDone(uint32_t time);
+    void handleWaylandSurfaceEnter(struct wl_output* output);
+    void handleWaylandSurfaceLeave(struct wl_output* output);
+    void handleWaylandOutputRemoved(struct wl_output* output);
+    void handleWaylandPreferredScale(uint32_t scale);
+    void handleWaylandFramePresented(struct wp_presentation_feedback* feedback, Time timestamp, uint32_t refresh, uint32_t flags);
+    void handleWaylandFrameDiscarded(struct wp_presentation_feedback* feedback);
 
     ////////////////////////////////////////////////////////////
     /// \brief Process incoming events from the operating system
@@ -213,7 +406,69 @@ public:
     ////////////////////////////////////////////////////////////
     virtual void processEvents();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until new events may be available from the compositor
+    ///
+    /// \param timeout Maximum time to wait (use Time::Zero for infinity)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void waitEvents(Time timeout);
+
 private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Read incoming events from the display connection
+    ///
+    /// The events are only queued; they are dispatched by processEvents.
+    /// When waiting for input (on the default queue), joystick activity
+    /// also ends the wait and key repeats that are due are generated.
+    /// When waiting on the frame queue of the window, only frame
+    /// callbacks, presentation feedback and buffer releases matter,
+    /// so that a rendering thread never has to handle input nor the
+    /// events of the window.
+    ///
+    /// \param timeout Maximum time to wait, in milliseconds (0 to return
+    ///                immediately, -1 for infinity)
+    /// \param queue   Queue that must be empty before reading, NULL for the default one
+    ///
+    ////////////////////////////////////////////////////////////
+    void readDisplayEvents(int timeout, struct wl_event_queue* queue);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle the loss of the connection to the compositor
+    ///
+    /// The error is reported once per display. Callable from any
+    /// thread: the next processEvents sends a Closed event.
+    ///
+    ////////////////////////////////////////////////////////////
+    void handleDisconnection();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current time on the compositor's presentation clock
+    ///
+    /// \return Current time
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getPresentationTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move a frame from the pending list to the timing queue
+    ///
+    /// \param feedback Feedback object of the frame, destroyed here
+    /// \param timing   Presentation information of the frame
+    ///
+    ////////////////////////////////////////////////////////////
+    void finishFrameFeedback(struct wp_presentation_feedback* feedback, FrameTiming& timing);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the output a fullscreen window should be shown on
+    ///
+    /// \param mode Video mode requested for the window, in pixels
+    ///
+    /// \return Output supporting the mode, or NULL to let the compositor choose
+    ///
+    ////////////////////////////////////////////////////////////
+    struct wl_output* findFullscreenOutput(const VideoMode& mode) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Do some common initializations after the window has been created
     ///
@@ -226,19 +481,237 @@ private:
     ////////////////////////////////////////////////////////////
     void cleanup();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Send the opaque region to the compositor
+    ///
+    /// It takes effect on the next commit of the surface.
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateOpaqueRegion();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send the presentation hint to the compositor
+    ///
+    /// It takes effect on the next commit of the surface.
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateTearingHint();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
 public:
     WaylandDisplay*         m_display;        ///< Pointer to the display
+    struct wl_event_queue*  m_queue;          ///< Queue of the events of this window's objects, dispatched by the event thread
+    struct wl_event_queue*  m_frame_queue;    ///< Queue of the frame events, dispatched by the rendering thread
+    struct wp_presentation* m_presentation;   ///< Wrapper of the presentation global creating feedbacks on m_frame_queue, if any
+    struct wl_surface*      m_frame_surface;  ///< Wrapper of m_surface creating frame callbacks on m_frame_queue
     struct wl_surface*      m_surface;
     struct xdg_surface*     m_xdg_surface;
     struct xdg_toplevel*    m_xdg_toplevel;
     struct zxdg_toplevel_decoration_v1* m_xdg_toplevel_deco;
     struct wl_egl_window*   m_egl_window;
+    Vector2u                m_egl_size;       ///< Size given to m_egl_window, only changed by the thread presenting frames
 
     bool m_xdg_initial_configure_seen;
+
+    struct wl_callback*     m_frame_callback; ///< Pending frame callback, if any
+    Clock                   m_frame_clock;    ///< Time since the last frame callback
+    Time                    m_frame_interval; ///< Estimated time between two frames
+    uint32_t                m_frame_time;     ///< Timestamp of the last frame callback, in milliseconds
 private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Frame waiting for its presentation feedback
+    ///
+    ////////////////////////////////////////////////////////////
+    struct PendingFrame
+    {
+        struct wp_presentation_feedback* feedback;  ///< Feedback object of the frame
+        Uint64                           frame;     ///< Index of the frame
+        Time                             submitted; ///< Time of the commit, on the presentation clock
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pointer state accumulated until the next wl_pointer.frame
+    ///
+    ////////////////////////////////////////////////////////////
+    struct PointerFrame
+    {
+        bool               moved;         ///< Has the pointer moved?
+        Vector2f           rawDelta;      ///< Unaccelerated relative motion
+        bool               rawMoved;      ///< Was relative motion reported?
+        std::vector<Event> buttons;       ///< Button events, in order, without position
+        double             axis[2];       ///< Scroll amount, per wl_pointer axis
+        bool               axisSet[2];    ///< Was the axis scrolled?
+        int                discrete[2];   ///< Wheel steps, per wl_pointer axis
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Turn the accumulated pointer state into events
+    ///
+    /// Motion comes first, so that button and wheel events carry
+    /// the final position of the frame.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushPointerFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue a motion event, merging it if coalescing is enabled
+    ///
+    /// \param event MouseMoved or MouseMovedRaw event
+    ///
+    ////////////////////////////////////////////////////////////
+    void pushMotionEvent(const Event& event);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Lock or confine the pointer according to the cursor state
+    ///
+    /// A grabbed and visible cursor is confined to the window; a
+    /// grabbed and hidden cursor is locked in place, so that only
+    /// MouseMovedRaw events report the motion.
+    ///
+    ////////////////////////////////////////////////////////////
+    void updatePointerConstraint();
+
+    struct zwp_locked_pointer_v1*   m_locked_pointer;   ///< Pointer lock, while active
+    struct zwp_confined_pointer_v1* m_confined_pointer; ///< Pointer confinement, while active
+    bool                            m_cursorVisible;    ///< Is the mouse cursor visible?
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Display the cursor of the window, if it has the pointer
+    ///
+    /// \param time Time used to pick the frame of animated cursors, in ms
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateCursor(uint32_t time);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the scale of the cursor images
+    ///
+    /// \return Integer scale of the outputs showing the window
+    ///
+    ////////////////////////////////////////////////////////////
+    int getCursorScale() const;
+
+    const CursorImplWayland*        m_cursor;                ///< Cursor to display, NULL for the default one
+    struct wl_surface*              m_cursor_surface;        ///< Surface showing the cursor while the window has the pointer
+    struct wl_callback*             m_cursor_frame_callback; ///< Next frame of an animated cursor, while pending
+    struct wl_buffer*               m_cursor_buffer;         ///< Image attached to the cursor surface
+    Vector2i                        m_cursor_hotspot;        ///< Hotspot of the attached image
+    int                             m_cursor_scale;          ///< Scale of the attached image
+    uint32_t                        m_pointer_serial;        ///< Serial of the latest pointer enter
+
+    PointerFrame             m_pointer_frame;  ///< Pointer state of the current wl_pointer.frame
+    bool                     m_coalesceMotion; ///< Merge unpolled MouseMoved events?
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Size the EGL window and surface scale for the current scale
+    ///
+    /// With high DPI rendering, fractional scales are applied through
+    /// a viewport, integer scales through the buffer scale.
+    ///
+    /// \return True if the framebuffer size changed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool updateBufferSize();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Cache the refresh rate of the output showing the window
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateOutputRefresh();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the buffer scale and viewport of the framebuffer size
+    ///
+    /// \param resize Resize the EGL window as well?
+    ///
+    ////////////////////////////////////////////////////////////
+    void applySurfaceState(bool resize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Notify the application that the framebuffer size changed
+    ///
+    /// Nothing happens if the framebuffer size didn't change.
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateBufferSizeAndNotify();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Shared memory buffer of the software presentation path
+    ///
+    ////////////////////////////////////////////////////////////
+    struct ShmBuffer
+    {
+        struct wl_buffer* buffer;   ///< Buffer object, NULL if not allocated
+        Uint8*            pixels;   ///< Mapped pixels of the buffer
+        bool              busy;     ///< Is the compositor still reading the buffer?
+        int               stale[4]; ///< Area changed since the buffer was last presented, as (left, top, width, height)
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allocate the shared memory buffers for the given size
+    ///
+    /// Both buffers live in a single memory-mapped pool.
+    ///
+    /// \param size Size of the buffers, in pixels
+    ///
+    /// \return True on success
+    ///
+    ////////////////////////////////////////////////////////////
+    bool createShmBuffers(const Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Release the shared memory buffers
+    ///
+    ////////////////////////////////////////////////////////////
+    void destroyShmBuffers();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy a rectangle of pixels between two shared memory buffers
+    ///
+    /// \param source      Buffer to read from
+    /// \param destination Buffer to write to
+    /// \param rect        Rectangle to copy (left, top, width, height)
+    ///
+    ////////////////////////////////////////////////////////////
+    void copyShmRect(const Uint8* source, Uint8* destination, const int* rect) const;
+
+    ShmBuffer          m_shm_buffers[2];  ///< Double-buffered pixels for software presentation
+    Uint8*             m_shm_memory;      ///< Mapping of the pool holding both buffers
+    std::size_t        m_shm_memory_size; ///< Size of the mapping, in bytes
+    Vector2u           m_shm_size;        ///< Size of the buffers, in pixels
+    int                m_shm_current;     ///< Index of the locked buffer, -1 if none
+    int                m_shm_last;        ///< Index of the last presented buffer, -1 if none
+    std::vector<Uint8> m_shm_staging;     ///< RGBA pixels, when the compositor can't take them directly
+
+    std::vector<struct wl_output*> m_outputs; ///< Outputs showing the window, most recently entered last
+    std::vector<int>               m_damage;  ///< Areas modified by the current frame, as (left, top, width, height)
+    std::vector<int>               m_opaque_areas;       ///< Opaque areas declared by the application, as (left, top, width, height)
+
+    bool                            m_tearing_allowed;  ///< May frames be presented with tearing?
+    bool                            m_vsync;            ///< Does the context of the window wait for vertical sync?
+    struct wp_tearing_control_v1*   m_tearing_control;  ///< Presentation hint of the surface, created on first use
+
+    bool                            m_highDpi;          ///< Is the framebuffer allocated in physical pixels?
+    uint32_t                        m_preferred_scale;  ///< Fractional scale preferred by the compositor, in 120ths (0 if unknown)
+    float                           m_render_scale;     ///< Ratio between the framebuffer size and its native size
+    Vector2u                        m_framebuffer_size; ///< Size of the framebuffer, in pixels (the EGL window follows between frames)
+    struct wp_viewport*             m_viewport;         ///< Viewport used for fractional and render scaling, if any
+    struct wp_fractional_scale_v1*  m_fractional_scale; ///< Source of the preferred fractional scale, if any
+
+    Uint64                   m_frame_count;    ///< Number of frames committed so far
+    std::deque<PendingFrame> m_pending_frames; ///< Frames not yet presented nor discarded
+    std::deque<FrameTiming>  m_frame_timings;  ///< Timings not yet returned to the user
+    int                      m_output_refresh; ///< Refresh rate of the output showing the window, in mHz (0 if unknown)
+    mutable Mutex            m_frame_mutex;    ///< Protects the frame interval, timings, output refresh, framebuffer size and surface state
+    int                      m_buffer_scale;   ///< Buffer scale matching m_framebuffer_size
+    Vector2i                 m_viewport_destination; ///< Viewport destination matching m_framebuffer_size, (-1, -1) if unset
+    bool                     m_presents_frames; ///< Does a context or lockPixels present frames, and thus apply the surface state?
+    int                      m_applied_scale;  ///< Buffer scale last sent to the compositor
+    Vector2i                 m_applied_destination; ///< Viewport destination last sent to the compositor
+    bool                     m_disconnect_notified; ///< Has the window been told that the connection was lost?
+
     int                m_screen;         ///< Screen identifier
 
     std::deque<Event> m_new_events;
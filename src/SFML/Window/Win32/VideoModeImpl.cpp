@@ -68,6 +68,14 @@ VideoMode VideoModeImpl::getDesktopMode()
     return VideoMode(win32Mode.dmPelsWidth, win32Mode.dmPelsHeight, win32Mode.dmBitsPerPel);
 }
 
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImpl::getMonitors()
+{
+    // Monitors are not enumerated yet, Monitor::getMonitors describes the desktop instead
+    return std::vector<Monitor>();
+}
+
 } // namespace priv
 
 } // namespace sf
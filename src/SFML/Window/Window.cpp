@@ -189,6 +189,75 @@ void Window::setFramerateLimit(unsigned int limit)
 }
 
 
+////////////////////////////////////////////////////////////
+Time Window::getTimeUntilNextFrame() const
+{
+    return m_impl ? m_impl->getTimeUntilNextFrame() : Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Window::pollFrameTiming(FrameTiming& timing)
+{
+    return m_impl && m_impl->popFrameTiming(timing);
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::setTearingAllowed(bool allowed)
+{
+    if (m_impl)
+        m_impl->setTearingAllowed(allowed);
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::setHighDpiEnabled(bool enabled)
+{
+    if (m_impl)
+        m_impl->setHighDpiEnabled(enabled);
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::setRenderScale(float scale)
+{
+    if (m_impl && (scale > 0.f))
+        m_impl->setRenderScale(scale);
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u Window::getFramebufferSize() const
+{
+    return m_impl ? m_impl->getFramebufferSize() : Vector2u();
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::addDamage(int left, int top, unsigned int width, unsigned int height)
+{
+    if (m_impl)
+        m_impl->addDamage(left, top, width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::addOpaqueArea(int left, int top, unsigned int width, unsigned int height)
+{
+    if (m_impl)
+        m_impl->addOpaqueArea(left, top, width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::resetOpaqueArea()
+{
+    if (m_impl)
+        m_impl->resetOpaqueArea();
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Window::setActive(bool active) const
 {
@@ -214,6 +283,9 @@ bool Window::setActive(bool active) const
 ////////////////////////////////////////////////////////////
 void Window::display()
 {
+    // Let derived classes finish their rendering
+    onDisplay();
+
     // Display the backbuffer on screen
     if (setActive())
         m_context->display();
@@ -227,6 +299,13 @@ void Window::display()
 }
 
 
+////////////////////////////////////////////////////////////
+void Window::onDisplay()
+{
+    // Nothing by default
+}
+
+
 ////////////////////////////////////////////////////////////
 void Window::initialize()
 {
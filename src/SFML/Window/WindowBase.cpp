@@ -29,6 +29,7 @@
 #include <SFML/Window/ContextSettings.hpp>
 #include <SFML/Window/WindowImpl.hpp>
 #include <SFML/System/Err.hpp>
+#include <cstring>
 
 
 namespace
@@ -183,6 +184,20 @@ bool WindowBase::waitEvent(Event& event)
 }
 
 
+////////////////////////////////////////////////////////////
+bool WindowBase::waitEvent(Event& event, Time timeout)
+{
+    if (m_impl && m_impl->popEvent(event, true, timeout))
+    {
+        return filterEvent(event);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2i WindowBase::getPosition() const
 {
@@ -278,6 +293,14 @@ void WindowBase::setKeyRepeatEnabled(bool enabled)
 }
 
 
+////////////////////////////////////////////////////////////
+void WindowBase::setMouseMoveCoalescingEnabled(bool enabled)
+{
+    if (m_impl)
+        m_impl->setMouseMoveCoalescingEnabled(enabled);
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowBase::setJoystickThreshold(float threshold)
 {
@@ -315,6 +338,48 @@ bool WindowBase::createVulkanSurface(const VkInstance& instance, VkSurfaceKHR& s
 }
 
 
+////////////////////////////////////////////////////////////
+Uint8* WindowBase::lockPixels()
+{
+    return m_impl ? m_impl->lockPixels() : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowBase::unlockPixels()
+{
+    if (m_impl)
+    {
+        Vector2u size = m_impl->getFramebufferSize();
+        m_impl->unlockPixels(0, 0, size.x, size.y);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowBase::unlockPixels(int left, int top, unsigned int width, unsigned int height)
+{
+    if (m_impl)
+        m_impl->unlockPixels(left, top, width, height);
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowBase::presentPixels(const Uint8* pixels)
+{
+    Uint8* buffer = lockPixels();
+    if (!buffer)
+        return false;
+
+    // The buffer has the size of the framebuffer at the time it was locked
+    Vector2u size = m_impl->getFramebufferSize();
+    std::memcpy(buffer, pixels, static_cast<std::size_t>(size.x) * size.y * 4);
+    m_impl->unlockPixels(0, 0, size.x, size.y);
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowBase::onCreate()
 {
@@ -29,6 +29,7 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/JoystickManager.hpp>
 #include <SFML/Window/SensorManager.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/System/Sleep.hpp>
 #include <algorithm>
 #include <cmath>
@@ -153,7 +154,14 @@ void WindowImpl::setJoystickThreshold(float threshold)
 
 
 ////////////////////////////////////////////////////////////
-bool WindowImpl::popEvent(Event& event, bool block)
+void WindowImpl::setMouseMoveCoalescingEnabled(bool /*enabled*/)
+{
+    // Mouse motion is not coalesced by default
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowImpl::popEvent(Event& event, bool block, Time timeout)
 {
     // If the event queue is empty, let's first check if new events are available from the OS
     if (m_events.empty())
@@ -166,12 +174,19 @@ bool WindowImpl::popEvent(Event& event, bool block)
         // In blocking mode, we must process events until one is triggered
         if (block)
         {
-            // Here we use a manual wait loop instead of the optimized
-            // wait-event provided by the OS, so that we don't skip joystick
-            // events (which require polling)
+            Clock clock;
             while (m_events.empty())
             {
-                sleep(milliseconds(10));
+                // Stop waiting once the timeout (if any) has expired
+                Time remaining = Time::Zero;
+                if (timeout != Time::Zero)
+                {
+                    remaining = timeout - clock.getElapsedTime();
+                    if (remaining <= Time::Zero)
+                        break;
+                }
+
+                waitEvents(remaining);
                 processJoystickEvents();
                 processSensorEvents();
                 processEvents();
@@ -199,6 +214,20 @@ void WindowImpl::pushEvent(const Event& event)
 }
 
 
+////////////////////////////////////////////////////////////
+void WindowImpl::waitEvents(Time timeout)
+{
+    // Here we use a manual wait loop instead of the optimized
+    // wait-event provided by the OS, so that we don't skip joystick
+    // events (which require polling)
+    Time delay = milliseconds(10);
+    if ((timeout != Time::Zero) && (timeout < delay))
+        delay = timeout;
+
+    sleep(delay);
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowImpl::processJoystickEvents()
 {
@@ -303,6 +332,86 @@ void WindowImpl::processSensorEvents()
 }
 
 
+////////////////////////////////////////////////////////////
+Time WindowImpl::getTimeUntilNextFrame() const
+{
+    // Frame timing is not reported by default
+    return Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+bool WindowImpl::popFrameTiming(FrameTiming& /*timing*/)
+{
+    // Presentation feedback is not reported by default
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::setTearingAllowed(bool /*allowed*/)
+{
+    // Frames are always synchronized by default
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::setHighDpiEnabled(bool /*enabled*/)
+{
+    // The framebuffer matches the window size by default
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::setRenderScale(float /*scale*/)
+{
+    // The framebuffer matches the window size by default
+}
+
+
+////////////////////////////////////////////////////////////
+Vector2u WindowImpl::getFramebufferSize() const
+{
+    return getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+Uint8* WindowImpl::lockPixels()
+{
+    // Software presentation is not supported by default
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::addDamage(int /*left*/, int /*top*/, unsigned int /*width*/, unsigned int /*height*/)
+{
+    // The whole window is presented by default
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::addOpaqueArea(int /*left*/, int /*top*/, unsigned int /*width*/, unsigned int /*height*/)
+{
+    // The compositor blends the whole window by default
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::resetOpaqueArea()
+{
+    // The compositor blends the whole window by default
+}
+
+
+////////////////////////////////////////////////////////////
+void WindowImpl::unlockPixels(int /*left*/, int /*top*/, unsigned int /*width*/, unsigned int /*height*/)
+{
+    // Software presentation is not supported by default
+}
+
+
 ////////////////////////////////////////////////////////////
 bool WindowImpl::createVulkanSurface(const VkInstance& instance, VkSurfaceKHR& surface, const VkAllocationCallbacks* allocator)
 {
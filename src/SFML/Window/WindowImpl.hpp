@@ -31,9 +31,11 @@
 #include <SFML/Config.hpp>
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/String.hpp>
+#include <SFML/System/Time.hpp>
 #include <SFML/Window/ContextSettings.hpp>
 #include <SFML/Window/CursorImpl.hpp>
 #include <SFML/Window/Event.hpp>
+#include <SFML/Window/FrameTiming.hpp>
 #include <SFML/Window/Joystick.hpp>
 #include <SFML/Window/JoystickImpl.hpp>
 #include <SFML/Window/Sensor.hpp>
@@ -105,14 +107,16 @@ public:
     /// window's internal event processing function.
     /// The \a block parameter controls the behavior of the function
     /// if no event is available: if it is true then the function
-    /// doesn't return until a new event is triggered; otherwise it
-    /// returns false to indicate that no event is available.
+    /// doesn't return until a new event is triggered or \a timeout
+    /// has elapsed; otherwise it returns false to indicate that no
+    /// event is available.
     ///
-    /// \param event Event to be returned
-    /// \param block Use true to block the thread until an event arrives
+    /// \param event   Event to be returned
+    /// \param block   Use true to block the thread until an event arrives
+    /// \param timeout Maximum time to block (use Time::Zero for infinity)
     ///
     ////////////////////////////////////////////////////////////
-    bool popEvent(Event& event, bool block);
+    bool popEvent(Event& event, bool block, Time timeout = Time::Zero);
 
     ////////////////////////////////////////////////////////////
     /// \brief Get the OS-specific handle of the window
@@ -212,6 +216,14 @@ public:
     ////////////////////////////////////////////////////////////
     virtual void setKeyRepeatEnabled(bool enabled) = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the coalescing of mouse motion
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setMouseMoveCoalescingEnabled(bool enabled);
+
     ////////////////////////////////////////////////////////////
     /// \brief Request the current window to be made the active
     ///        foreground window
@@ -227,6 +239,105 @@ public:
     ////////////////////////////////////////////////////////////
     virtual bool hasFocus() const = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the estimated time until the next frame is presented
+    ///
+    /// \return Time until the next presentation, or Time::Zero if
+    ///         the platform doesn't report frame timing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Time getTimeUntilNextFrame() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop the presentation timing of a displayed frame
+    ///
+    /// \param timing Timing to be filled
+    ///
+    /// \return True if a timing was returned, false if none is available
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool popFrameTiming(FrameTiming& timing);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allow or forbid tearing when presenting frames
+    ///
+    /// \param allowed True to allow tearing, false to forbid it
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setTearingAllowed(bool allowed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable rendering at the native resolution
+    ///
+    /// \param enabled True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setHighDpiEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the resolution at which the window is rendered
+    ///
+    /// \param scale Ratio between the framebuffer size and its normal size
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setRenderScale(float scale);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the framebuffer of the window
+    ///
+    /// \return Size of the framebuffer, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Vector2u getFramebufferSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a pixel buffer to render the next frame into
+    ///
+    /// \return Pointer to the RGBA pixels of the framebuffer size,
+    ///         or null if software presentation is not supported
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual Uint8* lockPixels();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area modified by the frame being rendered
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void addDamage(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Declare an area of the window as fully opaque
+    ///
+    /// \param left   X coordinate of the opaque area
+    /// \param top    Y coordinate of the opaque area
+    /// \param width  Width of the opaque area
+    /// \param height Height of the opaque area
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void addOpaqueArea(int left, int top, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restore the default opaque region of the window
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void resetOpaqueArea();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Present the frame rendered into the locked pixel buffer
+    ///
+    /// \param left   X coordinate of the modified area, in pixels
+    /// \param top    Y coordinate of the modified area, in pixels
+    /// \param width  Width of the modified area, in pixels
+    /// \param height Height of the modified area, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void unlockPixels(int left, int top, unsigned int width, unsigned int height);
+
     ////////////////////////////////////////////////////////////
     /// \brief Create a Vulkan rendering surface
     ///
@@ -265,6 +376,20 @@ protected:
     ////////////////////////////////////////////////////////////
     virtual void processEvents() = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until new events may be available from the operating system
+    ///
+    /// This function is called by popEvent in blocking mode, between
+    /// two calls to processEvents. The default implementation sleeps
+    /// for a short time, so that joystick and sensor events (which
+    /// require polling) are not skipped. Implementations that can
+    /// wait on their event sources directly should override it.
+    ///
+    /// \param timeout Maximum time to wait (use Time::Zero for infinity)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void waitEvents(Time timeout);
+
 private:
     ////////////////////////////////////////////////////////////
     /// \brief Read the joysticks state and generate the appropriate events
@@ -54,6 +54,14 @@ VideoMode VideoModeImpl::getDesktopMode()
     return VideoMode(bounds.size.width * backingScale, bounds.size.height * backingScale);
 }
 
+
+////////////////////////////////////////////////////////////
+std::vector<Monitor> VideoModeImpl::getMonitors()
+{
+    // Monitors are not enumerated yet, Monitor::getMonitors describes the desktop instead
+    return std::vector<Monitor>();
+}
+
 } // namespace priv
 
 } // namespace sf
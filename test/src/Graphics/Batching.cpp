@@ -0,0 +1,138 @@
+#include <SFML/Graphics/Batching.hpp>
+#include "GraphicsUtil.hpp"
+
+namespace
+{
+    // Vertices whose position, color and texture coordinates identify them
+    std::vector<sf::Vertex> makeVertices(std::size_t count)
+    {
+        std::vector<sf::Vertex> vertices;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float value = static_cast<float>(i);
+            vertices.push_back(sf::Vertex(sf::Vector2f(value, 0.f), sf::Color(static_cast<sf::Uint8>(i), 0, 0), sf::Vector2f(value, value)));
+        }
+
+        return vertices;
+    }
+
+    // Indices of the source vertices that a batch built without transform is made of
+    std::vector<int> getIndices(const std::vector<sf::Vertex>& batch)
+    {
+        std::vector<int> indices;
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            indices.push_back(static_cast<int>(batch[i].position.x));
+
+        return indices;
+    }
+
+    std::vector<int> batch(std::size_t vertexCount, sf::PrimitiveType type)
+    {
+        std::vector<sf::Vertex> vertices = makeVertices(vertexCount);
+        std::vector<sf::Vertex> result;
+        sf::priv::appendBatchVertices(result, &vertices[0], vertices.size(), type, sf::Transform::Identity);
+
+        return getIndices(result);
+    }
+
+    template <std::size_t N>
+    std::vector<int> expect(const int (&indices)[N])
+    {
+        return std::vector<int>(indices, indices + N);
+    }
+}
+
+TEST_CASE("sf::RenderTarget batching", "[graphics]")
+{
+    SECTION("Batch primitive type")
+    {
+        CHECK(sf::priv::getBatchPrimitiveType(sf::Points) == sf::Points);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::Lines) == sf::Lines);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::LineStrip) == sf::Lines);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::Triangles) == sf::Triangles);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::TriangleStrip) == sf::Triangles);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::TriangleFan) == sf::Triangles);
+        CHECK(sf::priv::getBatchPrimitiveType(sf::Quads) == sf::Triangles);
+    }
+
+    SECTION("Independent primitives")
+    {
+        const int points[] = {0, 1, 2, 3, 4};
+        CHECK(batch(5, sf::Points) == expect(points));
+
+        const int lines[] = {0, 1, 2, 3};
+        CHECK(batch(5, sf::Lines) == expect(lines));
+
+        const int triangles[] = {0, 1, 2};
+        CHECK(batch(5, sf::Triangles) == expect(triangles));
+    }
+
+    SECTION("Line strip")
+    {
+        const int lines[] = {0, 1, 1, 2, 2, 3};
+        CHECK(batch(4, sf::LineStrip) == expect(lines));
+        CHECK(batch(1, sf::LineStrip).empty());
+    }
+
+    SECTION("Triangle strip")
+    {
+        // Every other triangle of a strip is reversed to keep the winding
+        const int triangles[] = {0, 1, 2,
+                                 2, 1, 3,
+                                 2, 3, 4,
+                                 4, 3, 5};
+        CHECK(batch(6, sf::TriangleStrip) == expect(triangles));
+        CHECK(batch(2, sf::TriangleStrip).empty());
+    }
+
+    SECTION("Triangle fan")
+    {
+        const int triangles[] = {0, 1, 2,
+                                 0, 2, 3,
+                                 0, 3, 4};
+        CHECK(batch(5, sf::TriangleFan) == expect(triangles));
+        CHECK(batch(2, sf::TriangleFan).empty());
+    }
+
+    SECTION("Quads")
+    {
+        // The incomplete quad at the end is dropped
+        const int triangles[] = {0, 1, 2, 0, 2, 3,
+                                 4, 5, 6, 4, 6, 7};
+        CHECK(batch(10, sf::Quads) == expect(triangles));
+        CHECK(batch(3, sf::Quads).empty());
+    }
+
+    SECTION("Appending to a batch")
+    {
+        std::vector<sf::Vertex> vertices = makeVertices(4);
+        std::vector<sf::Vertex> result;
+        sf::priv::appendBatchVertices(result, &vertices[0], 3, sf::TriangleFan, sf::Transform::Identity);
+        sf::priv::appendBatchVertices(result, &vertices[1], 3, sf::TriangleStrip, sf::Transform::Identity);
+
+        const int triangles[] = {0, 1, 2,
+                                 1, 2, 3};
+        CHECK(getIndices(result) == expect(triangles));
+    }
+
+    SECTION("Transform")
+    {
+        std::vector<sf::Vertex> vertices = makeVertices(4);
+        std::vector<sf::Vertex> result;
+
+        sf::Transform transform;
+        transform.translate(10.f, 20.f);
+        transform.scale(2.f, 2.f);
+        sf::priv::appendBatchVertices(result, &vertices[0], vertices.size(), sf::Quads, transform);
+
+        REQUIRE(result.size() == 6);
+
+        // Only the positions are transformed
+        CHECK(result[5].position == sf::Vector2f(16.f, 20.f));
+        CHECK(result[5].texCoords == sf::Vector2f(3.f, 3.f));
+        CHECK(result[5].color == sf::Color(3, 0, 0));
+        CHECK(result[1].position == sf::Vector2f(12.f, 20.f));
+        CHECK(result[1].texCoords == sf::Vector2f(1.f, 1.f));
+        CHECK(result[1].color == sf::Color(1, 0, 0));
+    }
+}
@@ -0,0 +1,111 @@
+#include <SFML/Graphics/Batching.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include "GraphicsUtil.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Pack a transform like sf::SpriteBatch::add does for its instances
+    void packTransform(const sf::Transform& transform, float* packed)
+    {
+        const float* matrix = transform.getMatrix();
+
+        packed[0] = matrix[0];
+        packed[1] = matrix[4];
+        packed[2] = matrix[12];
+        packed[3] = matrix[1];
+        packed[4] = matrix[5];
+        packed[5] = matrix[13];
+    }
+}
+
+TEST_CASE("sf::SpriteBatch vertices", "[graphics]")
+{
+    sf::Vertex vertices[6];
+    float transform[6];
+    float textureRect[4] = {10.f, 20.f, 30.f, 40.f};
+
+    SECTION("Identity transform")
+    {
+        packTransform(sf::Transform::Identity, transform);
+        sf::priv::getSpriteVertices(transform, textureRect, sf::Color::Red, vertices);
+
+        // Two triangles, sharing the top-right and bottom-left corners
+        CHECK(vertices[0].position == sf::Vector2f(0.f, 0.f));
+        CHECK(vertices[1].position == sf::Vector2f(0.f, 40.f));
+        CHECK(vertices[2].position == sf::Vector2f(30.f, 0.f));
+        CHECK(vertices[3].position == sf::Vector2f(30.f, 0.f));
+        CHECK(vertices[4].position == sf::Vector2f(0.f, 40.f));
+        CHECK(vertices[5].position == sf::Vector2f(30.f, 40.f));
+    }
+
+    SECTION("Texture rectangle and color")
+    {
+        packTransform(sf::Transform::Identity, transform);
+        sf::priv::getSpriteVertices(transform, textureRect, sf::Color(1, 2, 3, 4), vertices);
+
+        CHECK(vertices[0].texCoords == sf::Vector2f(10.f, 20.f));
+        CHECK(vertices[1].texCoords == sf::Vector2f(10.f, 60.f));
+        CHECK(vertices[2].texCoords == sf::Vector2f(40.f, 20.f));
+        CHECK(vertices[5].texCoords == sf::Vector2f(40.f, 60.f));
+
+        for (int i = 0; i < 6; ++i)
+            CHECK(vertices[i].color == sf::Color(1, 2, 3, 4));
+    }
+
+    SECTION("Flipped texture rectangle")
+    {
+        // Negative sizes flip the texture, not the quad
+        float flipped[4] = {40.f, 60.f, -30.f, -40.f};
+        packTransform(sf::Transform::Identity, transform);
+        sf::priv::getSpriteVertices(transform, flipped, sf::Color::White, vertices);
+
+        CHECK(vertices[5].position == sf::Vector2f(30.f, 40.f));
+        CHECK(vertices[0].texCoords == sf::Vector2f(40.f, 60.f));
+        CHECK(vertices[5].texCoords == sf::Vector2f(10.f, 20.f));
+    }
+
+    SECTION("Transform")
+    {
+        sf::Transform translation;
+        translation.translate(100.f, 200.f);
+        translation.scale(2.f, 0.5f);
+        packTransform(translation, transform);
+        sf::priv::getSpriteVertices(transform, textureRect, sf::Color::White, vertices);
+
+        CHECK(vertices[0].position == sf::Vector2f(100.f, 200.f));
+        CHECK(vertices[1].position == sf::Vector2f(100.f, 220.f));
+        CHECK(vertices[2].position == sf::Vector2f(160.f, 200.f));
+        CHECK(vertices[5].position == sf::Vector2f(160.f, 220.f));
+    }
+
+    SECTION("Same bounds as sf::Sprite")
+    {
+        sf::Transformable transformable;
+        transformable.setOrigin(15.f, 20.f);
+        transformable.setRotation(90.f);
+        transformable.setPosition(50.f, 60.f);
+
+        packTransform(transformable.getTransform(), transform);
+        sf::priv::getSpriteVertices(transform, textureRect, sf::Color::White, vertices);
+
+        // Computed like sf::Sprite::getGlobalBounds
+        sf::FloatRect bounds = transformable.getTransform().transformRect(sf::FloatRect(0.f, 0.f, 30.f, 40.f));
+        float left = vertices[0].position.x;
+        float top = vertices[0].position.y;
+        float right = left;
+        float bottom = top;
+        for (int i = 1; i < 6; ++i)
+        {
+            left = std::min(left, vertices[i].position.x);
+            top = std::min(top, vertices[i].position.y);
+            right = std::max(right, vertices[i].position.x);
+            bottom = std::max(bottom, vertices[i].position.y);
+        }
+
+        CHECK(left == Approx(bounds.left));
+        CHECK(top == Approx(bounds.top));
+        CHECK(right - left == Approx(bounds.width));
+        CHECK(bottom - top == Approx(bounds.height));
+    }
+}